@@ -831,7 +831,7 @@ void CraftEquipmentState::btnClearClick(Action *)
 	if (_game->getSavedGame()->getMonthsPassed() == -1)
 	{
 		Craft* c = _base->getCrafts()->at(_craft);
-		c->getItems()->getContents()->clear();
+		c->getItems()->clear();
 	}
 }
 
@@ -864,7 +864,7 @@ void CraftEquipmentState::saveGlobalLoadout(int index)
 {
 	// clear the template
 	ItemContainer *tmpl = _game->getSavedGame()->getGlobalCraftLoadout(index);
-	tmpl->getContents()->clear();
+	tmpl->clear();
 
 	Craft *c = _base->getCrafts()->at(_craft);
 	// save only what is visible on the screen (can be DIFFERENT than what's really in the craft for various reasons)
@@ -913,9 +913,9 @@ void CraftEquipmentState::loadGlobalLoadout(int index)
 	Craft *c = _base->getCrafts()->at(_craft);
 	std::string craftName = c->getName(_game->getLanguage());
 	std::vector<ReequipStat> _missingItems;
-	for (auto& templateItem : *tmpl->getContents())
+	for (auto& templateItem : tmpl->getContents())
 	{
-		RuleItem *item = _game->getMod()->getItem(templateItem.first, false);
+		RuleItem *item = _game->getMod()->getItemById(templateItem.first, false);
 		if (item)
 		{
 			int tQty = templateItem.second;
@@ -89,6 +89,27 @@ void AIModule::reset()
 	_ambushTUs = 0;
 }
 
+/**
+ * Checks if the unit can walk to a tile and still afford an action there.
+ * @param pos The position to reach.
+ * @param cost The cost of the action.
+ * @return True if the tile is reachable.
+ */
+bool AIModule::isReachable(Position pos, const BattleActionCost &cost) const
+{
+	return _save->getPathfinding()->isReachable(_unit, cost, pos);
+}
+
+/**
+ * Checks if the unit can walk to a tile and still afford the attack picked in think().
+ * @param pos The position to reach.
+ * @return True if the tile is reachable, false if it isn't or the unit has no attack.
+ */
+bool AIModule::isReachableWithAttack(Position pos) const
+{
+	return _reachableWithAttackCost.type != BA_NONE && isReachable(pos, _reachableWithAttackCost);
+}
+
 /**
  * Loads the AI state from a YAML file.
  * @param node YAML node.
@@ -200,6 +221,8 @@ void AIModule::dont_think(BattleAction *action)
  */
 void AIModule::think(BattleAction *action)
 {
+	// no unit moves while deciding, so all path searches share one units stamp
+	ReachabilityCache::Decision decision(*_save->getReachabilityCache(), *_save->getUnits(), _unit);
 	action->type = BA_RETHINK;
 	action->actor = _unit;
 	action->weapon = _unit->getMainHandWeapon(false);
@@ -214,7 +237,6 @@ void AIModule::think(BattleAction *action)
 	_melee = (_unit->getUtilityWeapon(BT_MELEE) != 0);
 	_rifle = false;
 	_blaster = false;
-	_reachable = _save->getPathfinding()->findReachable(_unit, BattleActionCost());
 	_wasHitBy.clear();
 	_foundBaseModuleToDestroy = false;
 
@@ -269,18 +291,18 @@ void AIModule::think(BattleAction *action)
 				if (action->weapon->getCurrentWaypoints() != 0)
 				{
 					_blaster = true;
-					_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_AIMEDSHOT, _unit, action->weapon));
+					_reachableWithAttackCost = BattleActionCost(BA_AIMEDSHOT, _unit, action->weapon);
 				}
 				else
 				{
 					_rifle = true;
-					_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_SNAPSHOT, _unit, action->weapon));
+					_reachableWithAttackCost = BattleActionCost(BA_SNAPSHOT, _unit, action->weapon);
 				}
 			}
 			else if (rule->getBattleType() == BT_MELEE)
 			{
 				_melee = true;
-				_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_HIT, _unit, action->weapon));
+				_reachableWithAttackCost = BattleActionCost(BA_HIT, _unit, action->weapon);
 			}
 		}
 		else
@@ -496,6 +518,15 @@ void AIModule::setWeaponPickedUp()
 	_weaponPickedUp = true;
 }
 
+/**
+ * Sets the faction this unit attacks.
+ * @param faction Faction of the targets.
+ */
+void AIModule::setTargetFaction(UnitFaction faction)
+{
+	_targetFaction = faction;
+}
+
 /*
  * Gets whether the unit was hit.
  * @return if it was hit.
@@ -698,7 +729,7 @@ void AIModule::setupAmbush()
 			Position pos = (*i)->getPosition();
 			Tile *tile = _save->getTile(pos);
 			if (tile == 0 || Position::distance2d(pos, _unit->getPosition()) > 10 || pos.z != _unit->getPosition().z || tile->getDangerous() ||
-				std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
+				!isReachableWithAttack(pos))
 				continue; // just ignore unreachable tiles
 
 			if (_traceAI)
@@ -997,7 +1028,7 @@ void AIModule::setupEscape()
 		else
 		{
 			spotters = getSpottingUnits(_escapeAction->target);
-			if (std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(_escapeAction->target))  == _reachable.end())
+			if (!isReachable(_escapeAction->target, BattleActionCost()))
 				continue; // just ignore unreachable tiles
 
 			if (_spottingEnemies || spotters)
@@ -1109,7 +1140,8 @@ int AIModule::getSpottingUnits(const Position& pos) const
 	// if we don't actually occupy the position being checked, we need to do a virtual LOF check.
 	bool checking = pos != _unit->getPosition();
 	int tally = 0;
-	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	_save->getUnitsInRange(pos, 20, _spottersInRange);
+	for (std::vector<BattleUnit*>::const_iterator i = _spottersInRange.begin(); i != _spottersInRange.end(); ++i)
 	{
 		if (validTarget(*i, false, false))
 		{
@@ -1148,7 +1180,9 @@ int AIModule::selectNearestTarget()
 	_closestDist= 100;
 	_aggroTarget = 0;
 	Position target;
-	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	// only units in view distance can be visible
+	_save->getUnitsInRange(_unit->getPosition(), _save->getTileEngine()->getMaxViewDistance(), _targetsInRange);
+	for (std::vector<BattleUnit*>::const_iterator i = _targetsInRange.begin(); i != _targetsInRange.end(); ++i)
 	{
 		if (validTarget(*i, true, _unit->getFaction() == FACTION_HOSTILE) &&
 			_save->getTileEngine()->visible(_unit, (*i)->getTile()))
@@ -1202,7 +1236,9 @@ int AIModule::selectNearestTargetLeeroy()
 	int tally = 0;
 	_closestDist = 100;
 	_aggroTarget = 0;
-	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	// only units in view distance can be visible
+	_save->getUnitsInRange(_unit->getPosition(), _save->getTileEngine()->getMaxViewDistance(), _targetsInRange);
+	for (std::vector<BattleUnit*>::const_iterator i = _targetsInRange.begin(); i != _targetsInRange.end(); ++i)
 	{
 		if (validTarget(*i, true, _unit->getFaction() == FACTION_HOSTILE) &&
 			_save->getTileEngine()->visible(_unit, (*i)->getTile()))
@@ -1304,7 +1340,7 @@ bool AIModule::selectPointNearTarget(BattleUnit *target, int maxTUs) const
 				if (x || y) // skip the unit itself
 				{
 					Position checkPath = target->getPosition() + Position (x, y, z);
-					if (_save->getTile(checkPath) == 0 || std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(checkPath))  == _reachable.end())
+					if (_save->getTile(checkPath) == 0 || !isReachable(checkPath, BattleActionCost()))
 						continue;
 					int dir = _save->getTileEngine()->getDirectionTo(checkPath, target->getPosition());
 					bool valid = _save->getTileEngine()->validMeleeRange(checkPath, dir, _unit, target, 0);
@@ -1355,7 +1391,7 @@ bool AIModule::selectPointNearTargetLeeroy(BattleUnit *target) const
 				if (x || y) // skip the unit itself
 				{
 					Position checkPath = target->getPosition() + Position(x, y, z);
-					if (_save->getTile(checkPath) == 0 || std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(checkPath)) == _reachable.end())
+					if (_save->getTile(checkPath) == 0 || !isReachable(checkPath, BattleActionCost()))
 						continue;
 					int dir = _save->getTileEngine()->getDirectionTo(checkPath, target->getPosition());
 					bool valid = _save->getTileEngine()->validMeleeRange(checkPath, dir, _unit, target, 0);
@@ -1826,7 +1862,7 @@ bool AIModule::findFirePoint()
 		Position pos = _unit->getPosition() + *i;
 		Tile *tile = _save->getTile(pos);
 		if (tile == 0  ||
-			std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
+			!isReachableWithAttack(pos))
 			continue;
 		int score = 0;
 		// i should really make a function for this
@@ -2742,7 +2778,7 @@ void AIModule::selectMeleeOrRanged()
 		{
 			_rifle = false;
 			_attackAction->weapon = melee;
-			_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_HIT, _unit, melee));
+			_reachableWithAttackCost = BattleActionCost(BA_HIT, _unit, melee);
 			return;
 		}
 	}
@@ -52,14 +52,23 @@ private:
 	int _AIMode, _intelligence, _closestDist;
 	Node *_fromNode, *_toNode;
 	bool _foundBaseModuleToDestroy;
-	std::vector<int> _reachable, _reachableWithAttack, _wasHitBy;
+	std::vector<int> _wasHitBy;
+	/// Cost of the attack the unit wants to afford after moving, type BA_NONE if it has none.
+	BattleActionCost _reachableWithAttackCost;
 	BattleActionType _reserve;
 	UnitFaction _targetFaction;
+	/// Reused results of SavedBattleGame::getUnitsInRange.
+	std::vector<BattleUnit*> _targetsInRange;
+	mutable std::vector<BattleUnit*> _spottersInRange;
 
 	bool selectPointNearTargetLeeroy(BattleUnit *target) const;
 	int selectNearestTargetLeeroy();
 	void meleeActionLeeroy();
 	void dont_think(BattleAction *action);
+	/// Checks if the unit can walk to a tile and still afford an action there.
+	bool isReachable(Position pos, const BattleActionCost &cost) const;
+	/// Checks if the unit can walk to a tile and still afford its planned attack there.
+	bool isReachableWithAttack(Position pos) const;
 public:
 	/// Creates a new AIModule linked to the game and a certain unit.
 	AIModule(SavedBattleGame *save, BattleUnit *unit, Node *node);
@@ -77,6 +86,8 @@ public:
 	void setWasHitBy(BattleUnit *attacker);
 	/// Sets the "unit picked up a weapon" flag.
 	void setWeaponPickedUp();
+	/// Sets the faction this unit attacks.
+	void setTargetFaction(UnitFaction faction);
 	/// Gets whether the unit was hit.
 	bool getWasHitBy(int attacker) const;
 	/// setup a patrol objective.
@@ -0,0 +1,362 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattleRecording.h"
+#include <sstream>
+#include "../md5.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/RNG.h"
+#include "../Mod/MapData.h"
+#include "../Mod/RuleInventory.h"
+#include "../Mod/RuleItem.h"
+#include "../Savegame/BattleItem.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SavedGame.h"
+#include "../Savegame/SaveWriter.h"
+#include "../Savegame/Tile.h"
+
+namespace OpenXcom
+{
+
+BattleRecording *BattleRecording::_pendingReplay = 0;
+int BattleRecording::_replayMismatches = 0;
+
+/**
+ * Loads the input from a YAML file.
+ * @param node YAML node.
+ */
+void BattleInput::load(const YAML::Node &node)
+{
+	type = (BattleInputType)node["type"].as<int>();
+	turn = node["turn"].as<int>(0);
+	seed = node["seed"].as<uint64_t>();
+	pos = node["pos"].as<Position>(Position(-1, -1, -1));
+	mods = node["mods"].as<int>(0);
+	selected = node["selected"].as<int>(-1);
+	actor = node["actor"].as<int>(-1);
+	weapon = node["weapon"].as<int>(-1);
+	action = (BattleActionType)node["action"].as<int>(BA_NONE);
+	targeting = node["targeting"].as<bool>(false);
+	sprayTargeting = node["sprayTargeting"].as<bool>(false);
+	waypoints = node["waypoints"].as<std::vector<Position> >(std::vector<Position>());
+}
+
+/**
+ * Saves the input to a YAML file.
+ * @return YAML node.
+ */
+YAML::Node BattleInput::save() const
+{
+	YAML::Node node;
+	node.SetStyle(YAML::EmitterStyle::Flow);
+	node["type"] = (int)type;
+	node["turn"] = turn;
+	node["seed"] = seed;
+	if (type == BIT_PRIMARY || type == BIT_SECONDARY)
+	{
+		node["pos"] = pos;
+	}
+	if (mods != 0)
+	{
+		node["mods"] = mods;
+	}
+	node["selected"] = selected;
+	node["actor"] = actor;
+	node["weapon"] = weapon;
+	node["action"] = (int)action;
+	if (targeting)
+	{
+		node["targeting"] = targeting;
+	}
+	if (sprayTargeting)
+	{
+		node["sprayTargeting"] = sprayTargeting;
+	}
+	if (!waypoints.empty())
+	{
+		node["waypoints"] = waypoints;
+	}
+	return node;
+}
+
+/**
+ * Creates an empty recording.
+ * @param name Name of the recording in the user folder, without extension.
+ * @param replay Is the recording going to be played back?
+ */
+BattleRecording::BattleRecording(const std::string &name, bool replay) : _name(name), _replay(replay), _started(false), _diverged(false), _next(0)
+{
+}
+
+/**
+ * Gets the name of the save the recording starts from.
+ * @return Filename in the user folder.
+ */
+std::string BattleRecording::getSaveName() const
+{
+	return _name + ".sav";
+}
+
+/**
+ * Saves the game as the start of the recording. Done on the
+ * first input, so the save holds the exact random seed of it.
+ * @param game Pointer to the core game.
+ */
+void BattleRecording::start(Game *game)
+{
+	_started = true;
+	try
+	{
+		YAML::Node brief;
+		std::string data = game->getSavedGame()->save(game->getMod(), brief);
+		SaveWriter::getShared().wait();
+		std::string err = SaveWriter::write(getSaveName(), data, brief);
+		if (!err.empty())
+		{
+			throw Exception(err);
+		}
+		Log(LOG_INFO) << "Recording battle input into " << _name;
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << "Battle recording: " << e.what();
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << "Battle recording: " << e.what();
+	}
+}
+
+/**
+ * Adds an input of the player to the recording.
+ * @param input Recorded input.
+ */
+void BattleRecording::add(const BattleInput &input)
+{
+	_inputs.push_back(input);
+}
+
+/**
+ * Gets the next input to play back. The first input sets the
+ * random seed, every other one checks it to spot where the
+ * replay stops matching the recording.
+ * @return Pointer to the input, or null when all were played.
+ */
+const BattleInput *BattleRecording::next()
+{
+	if (_next == _inputs.size())
+	{
+		return 0;
+	}
+	const BattleInput *input = &_inputs[_next];
+	if (_next == 0)
+	{
+		RNG::setSeed(input->seed);
+	}
+	else if (!_diverged && RNG::getSeed() != input->seed)
+	{
+		_diverged = true;
+		Log(LOG_WARNING) << "Replay of " << _name << " went different from the recording at input " << _next << " (turn " << input->turn << ")";
+	}
+	++_next;
+	return input;
+}
+
+/**
+ * Ends the recording and saves it with the final checksum,
+ * or ends the replay and compares the final checksums.
+ * @param battle Final state of the battle.
+ */
+void BattleRecording::finish(SavedBattleGame *battle)
+{
+	if (!_replay && !_started)
+	{
+		return;
+	}
+	std::string sum = checksum(battle);
+	if (!_replay)
+	{
+		_checksum = sum;
+		save();
+		Log(LOG_INFO) << "Recorded " << _inputs.size() << " inputs into " << _name << ", battle checksum " << sum;
+	}
+	else
+	{
+		Log(LOG_INFO) << "Replayed " << _next << " of " << _inputs.size() << " inputs of " << _name << ", battle checksum " << sum;
+		bool matched = !_diverged;
+		if (_next < _inputs.size())
+		{
+			Log(LOG_WARNING) << "Replay ended before all recorded inputs were played";
+			matched = false;
+		}
+		else if (!_checksum.empty())
+		{
+			if (sum == _checksum)
+			{
+				Log(LOG_INFO) << "Replay matches the recording";
+			}
+			else
+			{
+				Log(LOG_WARNING) << "Replay does not match the recording, its checksum was " << _checksum;
+				matched = false;
+			}
+		}
+		if (!matched)
+		{
+			++_replayMismatches;
+		}
+	}
+}
+
+/**
+ * Loads the recording from the user folder.
+ * @return True if it was loaded.
+ */
+bool BattleRecording::load()
+{
+	try
+	{
+		YAML::Node doc = YAML::Load(*CrossPlatform::readFile(Options::getMasterUserFolder() + _name + ".rec"));
+		_checksum = doc["checksum"].as<std::string>("");
+		_inputs.clear();
+		for (const YAML::Node &i : doc["inputs"])
+		{
+			BattleInput input;
+			input.load(i);
+			_inputs.push_back(input);
+		}
+		_next = 0;
+		return true;
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << "Battle recording: " << e.what();
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << "Battle recording: " << e.what();
+	}
+	return false;
+}
+
+/**
+ * Saves the recording to the user folder.
+ * Nothing is saved for replays or recordings not started yet.
+ */
+void BattleRecording::save() const
+{
+	if (_replay || !_started)
+	{
+		return;
+	}
+	YAML::Emitter out;
+	YAML::Node doc;
+	if (!_checksum.empty())
+	{
+		doc["checksum"] = _checksum;
+	}
+	for (const BattleInput &i : _inputs)
+	{
+		doc["inputs"].push_back(i.save());
+	}
+	out << doc;
+	std::string filename = Options::getMasterUserFolder() + _name + ".rec";
+	if (!CrossPlatform::writeFile(filename, std::string(out.c_str()) + "\n"))
+	{
+		Log(LOG_ERROR) << "Failed to save " << filename;
+	}
+}
+
+/**
+ * Gets a checksum of the battle logic state, to compare the end
+ * of a replay with the recording: the turn, every unit, item and
+ * tile, but nothing only shown on screen, like animation frames.
+ * @param battle Battle to check.
+ * @return MD5 of the logic state.
+ */
+std::string BattleRecording::checksum(SavedBattleGame *battle)
+{
+	std::ostringstream out;
+	out << battle->getTurn() << " " << battle->getSide() << "\n";
+	for (const BattleUnit *unit : *battle->getUnits())
+	{
+		out << "unit " << unit->getId() << " " << unit->getPosition() << " " << unit->getDirection() << " " << unit->getTurretDirection()
+			<< " " << unit->getStatus() << " " << unit->getFaction() << " " << unit->getTimeUnits() << " " << unit->getEnergy()
+			<< " " << unit->getHealth() << " " << unit->getMana() << " " << unit->getMorale() << " " << unit->getStunlevel()
+			<< " " << unit->getFatalWounds() << "\n";
+	}
+	for (const BattleItem *item : *battle->getItems())
+	{
+		out << "item " << item->getId() << " " << item->getRules()->getType()
+			<< " " << (item->getOwner() ? item->getOwner()->getId() : -1)
+			<< " " << (item->getSlot() ? item->getSlot()->getId() : std::string("-"))
+			<< " " << item->getSlotX() << " " << item->getSlotY()
+			<< " " << (item->getTile() ? item->getTile()->getPosition() : Position(-1, -1, -1))
+			<< " " << item->getAmmoQuantity() << " " << item->getFuseTimer() << "\n";
+	}
+	for (int i = 0; i < battle->getMapSizeXYZ(); ++i)
+	{
+		const Tile *tile = battle->getTile(i);
+		out << "tile";
+		for (int part = O_FLOOR; part < O_MAX; ++part)
+		{
+			int id, setId;
+			tile->getMapData(&id, &setId, (TilePart)part);
+			out << " " << setId << ":" << id;
+		}
+		out << " " << tile->getFire() << " " << tile->getSmoke() << " " << tile->getExplosive() << "\n";
+	}
+	return md5(out.str());
+}
+
+/**
+ * Gets the number of replays that did not match their recording.
+ * @return Number of failed replays.
+ */
+int BattleRecording::getReplayMismatches()
+{
+	return _replayMismatches;
+}
+
+/**
+ * Sets the replay the next battle to start will play back.
+ * @param replay Loaded recording, the battle takes it over.
+ */
+void BattleRecording::setPendingReplay(BattleRecording *replay)
+{
+	delete _pendingReplay;
+	_pendingReplay = replay;
+}
+
+/**
+ * Takes the replay for a battle that is starting.
+ * @return Pointer to the replay, or null if there is none.
+ */
+BattleRecording *BattleRecording::takePendingReplay()
+{
+	BattleRecording *replay = _pendingReplay;
+	_pendingReplay = 0;
+	return replay;
+}
+
+}
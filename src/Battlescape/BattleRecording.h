@@ -0,0 +1,103 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <yaml-cpp/yaml.h>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+class Game;
+class SavedBattleGame;
+enum BattleActionType : Uint8;
+
+/// Kinds of player input kept in a battle recording.
+enum BattleInputType { BIT_PRIMARY, BIT_SECONDARY, BIT_LAUNCH, BIT_END_TURN };
+
+/**
+ * One input of the player to the battle, with the action
+ * it was given for and the random seed at that moment.
+ */
+struct BattleInput
+{
+	BattleInputType type;
+	int turn;
+	uint64_t seed;
+	Position pos;
+	int mods; // keyboard modifiers
+	int selected, actor, weapon; // unit and item ids, -1 for none
+	BattleActionType action;
+	bool targeting, sprayTargeting;
+	std::vector<Position> waypoints;
+
+	/// Loads the input from YAML.
+	void load(const YAML::Node &node);
+	/// Saves the input to YAML.
+	YAML::Node save() const;
+};
+
+/**
+ * Records the player's input to a battle, or plays a recording back.
+ * Recording starts with a save of the battle, so a replay loads the
+ * same save, gets the same random numbers and ends in the same state.
+ */
+class BattleRecording
+{
+private:
+	static BattleRecording *_pendingReplay;
+	static int _replayMismatches;
+	std::string _name, _checksum;
+	bool _replay, _started, _diverged;
+	std::vector<BattleInput> _inputs;
+	size_t _next;
+public:
+	/// Creates an empty recording.
+	BattleRecording(const std::string &name, bool replay);
+	/// Gets the name of the save the recording starts from.
+	std::string getSaveName() const;
+	/// Is this a recording being played back?
+	bool isReplay() const { return _replay; }
+	/// Has the recording started?
+	bool isStarted() const { return _started; }
+	/// Saves the game the recording starts from.
+	void start(Game *game);
+	/// Adds an input of the player.
+	void add(const BattleInput &input);
+	/// Gets the next input to play back.
+	const BattleInput *next();
+	/// Ends the recording or the replay with the final state of the battle.
+	void finish(SavedBattleGame *battle);
+	/// Loads the recording from the user folder.
+	bool load();
+	/// Saves the recording to the user folder.
+	void save() const;
+	/// Gets a checksum of the logic state of a battle.
+	static std::string checksum(SavedBattleGame *battle);
+	/// Gets the number of replays that did not match their recording.
+	static int getReplayMismatches();
+	/// Sets the replay for the next battle to start.
+	static void setPendingReplay(BattleRecording *replay);
+	/// Takes the replay for a starting battle, if any.
+	static BattleRecording *takePendingReplay();
+};
+
+}
@@ -19,6 +19,7 @@
 #include <sstream>
 #include "BattlescapeGame.h"
 #include "BattlescapeState.h"
+#include "BattlescapeSimulation.h"
 #include "Map.h"
 #include "Camera.h"
 #include "NextTurnState.h"
@@ -178,7 +179,7 @@ bool BattleActionCost::spendTU(std::string *message)
 BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) :
 	_save(save), _parentState(parentState),
 	_playerPanicHandled(true), _AIActionCounter(0), _AISecondMove(false), _playedAggroSound(false),
-	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false)
+	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false), _autoPlay(false), _recording(0)
 {
 
 	_currentAction.actor = 0;
@@ -188,6 +189,12 @@ BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parent
 
 	_debugPlay = false;
 
+	_recording = BattleRecording::takePendingReplay();
+	if (!_recording && !Options::getRecordBattle().empty())
+	{
+		_recording = new BattleRecording(Options::getRecordBattle(), false);
+	}
+
 	spawnFromPrimedItems();
 	checkForCasualties(nullptr, BattleActionAttack{ }, true);
 	cancelCurrentAction();
@@ -204,6 +211,11 @@ BattlescapeGame::~BattlescapeGame()
 		delete *i;
 	}
 	cleanupDeleted();
+	if (_recording)
+	{
+		_recording->save();
+		delete _recording;
+	}
 }
 
 /**
@@ -220,8 +232,8 @@ void BattlescapeGame::think()
 			_save->setUnitsFalling(false);
 			return;
 		}
-		// it's a non player side (ALIENS or CIVILIANS)
-		if (_save->getSide() != FACTION_PLAYER)
+		// it's a non player side (ALIENS or CIVILIANS), or the AI plays for the player too
+		if (_save->getSide() != FACTION_PLAYER || _autoPlay)
 		{
 			_save->resetUnitHitStates();
 			if (!_debugPlay)
@@ -257,6 +269,19 @@ void BattlescapeGame::think()
 				_playerPanicHandled = handlePanickingPlayer();
 				_save->getBattleState()->updateSoldierInfo();
 			}
+			else if (isReplaying())
+			{
+				// the recording plays for the player, until it runs out
+				const BattleInput *input = _recording->next();
+				if (input)
+				{
+					replayInput(*input);
+				}
+				else
+				{
+					finishRecording();
+				}
+			}
 		}
 	}
 }
@@ -279,6 +304,7 @@ void BattlescapeGame::init()
  */
 void BattlescapeGame::handleAI(BattleUnit *unit)
 {
+	BattleProfileScope profile(BPP_AI);
 	std::ostringstream ss;
 
 	if (unit->getTimeUnits() <= 5)
@@ -1171,7 +1197,7 @@ void BattlescapeGame::popState()
 	// handle the end of this unit's actions
 	if (action.actor && noActionsPending(action.actor))
 	{
-		if (action.actor->getFaction() == FACTION_PLAYER)
+		if (action.actor->getFaction() == FACTION_PLAYER && !_autoPlay)
 		{
 			if (_save->getSide() == FACTION_PLAYER)
 			{
@@ -1192,7 +1218,7 @@ void BattlescapeGame::popState()
 		}
 		else
 		{
-			if (_save->getSide() != FACTION_PLAYER && !_debugPlay)
+			if ((_save->getSide() != FACTION_PLAYER || _autoPlay) && !_debugPlay)
 			{
 				// AI does three things per unit, before switching to the next, or it got killed before doing the second thing
 				if (_AIActionCounter > 2 || _save->getSelectedUnit() == 0 || _save->getSelectedUnit()->isOut())
@@ -1644,6 +1670,7 @@ bool BattlescapeGame::isBusy() const
  */
 void BattlescapeGame::primaryAction(Position pos)
 {
+	recordInput(BIT_PRIMARY, pos);
 	bool bPreviewed = Options::battleNewPreviewPath != PATH_NONE;
 
 	getMap()->resetObstacles();
@@ -1876,6 +1903,7 @@ void BattlescapeGame::primaryAction(Position pos)
  */
 void BattlescapeGame::secondaryAction(Position pos)
 {
+	recordInput(BIT_SECONDARY, pos);
 	//  -= turn to or open door =-
 	_currentAction.target = pos;
 	_currentAction.actor = _save->getSelectedUnit();
@@ -1888,6 +1916,7 @@ void BattlescapeGame::secondaryAction(Position pos)
  */
 void BattlescapeGame::launchAction()
 {
+	recordInput(BIT_LAUNCH, Position(-1, -1, -1));
 	_parentState->showLaunchButton(false);
 	getMap()->getWaypoints()->clear();
 	_currentAction.target = _currentAction.waypoints.front();
@@ -2022,6 +2051,127 @@ void BattlescapeGame::requestEndTurn(bool askForConfirmation)
 	}
 }
 
+/**
+ * Adds the end of turn to the battle recording. Only for the player's
+ * own request, turns ended by the game itself end the same way in a replay.
+ */
+void BattlescapeGame::recordEndTurn()
+{
+	if (!_endTurnRequested)
+	{
+		recordInput(BIT_END_TURN, Position(-1, -1, -1));
+	}
+}
+
+/**
+ * Adds an input of the player to the battle recording, with the
+ * action it was given for. The first input also saves the game,
+ * so a replay can start from the same state.
+ * @param type Kind of input.
+ * @param pos Position on the map, if any.
+ */
+void BattlescapeGame::recordInput(BattleInputType type, Position pos)
+{
+	if (!_recording || _recording->isReplay() || _autoPlay || _save->getSide() != FACTION_PLAYER)
+	{
+		return;
+	}
+	if (!_recording->isStarted())
+	{
+		_recording->start(_parentState->getGame());
+	}
+	BattleInput input;
+	input.type = type;
+	input.turn = _save->getTurn();
+	input.seed = RNG::getSeed();
+	input.pos = pos;
+	input.mods = SDL_GetModState();
+	input.selected = _save->getSelectedUnit() ? _save->getSelectedUnit()->getId() : -1;
+	input.actor = _currentAction.actor ? _currentAction.actor->getId() : -1;
+	input.weapon = _currentAction.weapon ? _currentAction.weapon->getId() : -1;
+	input.action = _currentAction.type;
+	input.targeting = _currentAction.targeting;
+	input.sprayTargeting = _currentAction.sprayTargeting;
+	input.waypoints.assign(_currentAction.waypoints.begin(), _currentAction.waypoints.end());
+	_recording->add(input);
+	if (type == BIT_END_TURN)
+	{
+		_recording->save();
+	}
+}
+
+/**
+ * Plays back a recorded input of the player. The action it was given
+ * for is restored first, as it was set up by menus that are not recorded.
+ * @param input Recorded input.
+ */
+void BattlescapeGame::replayInput(const BattleInput &input)
+{
+	BattleUnit *selected = 0;
+	_currentAction.actor = 0;
+	_currentAction.weapon = 0;
+	for (BattleUnit *unit : *_save->getUnits())
+	{
+		if (unit->getId() == input.selected)
+			selected = unit;
+		if (unit->getId() == input.actor)
+			_currentAction.actor = unit;
+	}
+	for (BattleItem *item : *_save->getItems())
+	{
+		if (item->getId() == input.weapon)
+			_currentAction.weapon = item;
+	}
+	if (selected != _save->getSelectedUnit())
+	{
+		_save->setSelectedUnit(selected);
+		_parentState->updateSoldierInfo();
+	}
+	_currentAction.type = input.action;
+	_currentAction.targeting = input.targeting;
+	_currentAction.sprayTargeting = input.sprayTargeting;
+	_currentAction.waypoints.assign(input.waypoints.begin(), input.waypoints.end());
+	getMap()->getWaypoints()->assign(input.waypoints.begin(), input.waypoints.end());
+	if (_currentAction.actor && _currentAction.weapon)
+	{
+		_currentAction.updateTU();
+	}
+
+	// the input reads the keyboard modifiers held when it was recorded
+	SDLMod mods = SDL_GetModState();
+	SDL_SetModState((SDLMod)input.mods);
+	switch (input.type)
+	{
+	case BIT_PRIMARY:
+		primaryAction(input.pos);
+		break;
+	case BIT_SECONDARY:
+		secondaryAction(input.pos);
+		break;
+	case BIT_LAUNCH:
+		launchAction();
+		break;
+	case BIT_END_TURN:
+		requestEndTurn(false);
+		break;
+	}
+	SDL_SetModState(mods);
+}
+
+/**
+ * Ends the battle recording and saves it, or ends the replay and
+ * logs how the final state compares, then lets the player take over.
+ */
+void BattlescapeGame::finishRecording()
+{
+	if (_recording)
+	{
+		_recording->finish(_save);
+		delete _recording;
+		_recording = 0;
+	}
+}
+
 /**
  * Sets the TU reserved type.
  * @param tur A BattleActionType.
@@ -2086,6 +2236,7 @@ BattleUnit *BattlescapeGame::convertUnit(BattleUnit *unit)
 	newUnit->setDirection(unit->getDirection());
 	newUnit->clearTimeUnits();
 	getSave()->getUnits()->push_back(newUnit);
+	getSave()->invalidateUnitIndex();
 	newUnit->setAIModule(new AIModule(getSave(), newUnit, 0));
 	newUnit->setVisible(visible);
 
@@ -2206,6 +2357,7 @@ void BattlescapeGame::spawnNewUnit(BattleActionAttack attack, Position position)
 		newUnit->setDirection(unitDirection);
 		newUnit->clearTimeUnits();
 		getSave()->getUnits()->push_back(newUnit);
+		getSave()->invalidateUnitIndex();
 		if (faction != FACTION_PLAYER)
 		{
 			newUnit->setAIModule(new AIModule(getSave(), newUnit, 0));
@@ -2277,6 +2429,7 @@ void BattlescapeGame::removeSummonedPlayerUnits()
 			(*unit)->setTile(nullptr, _save);
 			delete (*unit);
 			unit = _save->getUnits()->erase(unit);
+			_save->invalidateUnitIndex();
 		}
 	}
 
@@ -2297,6 +2450,7 @@ void BattlescapeGame::removeSummonedPlayerUnits()
 		newUnit->setAIModule(new AIModule(_save, newUnit, 0));
 		newUnit->markAsResummonedFakeCivilian();
 		_save->getUnits()->push_back(newUnit);
+		_save->invalidateUnitIndex();
 	}
 }
 
@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http:///www.gnu.org/licenses/>.
  */
 #include "Position.h"
+#include "BattleRecording.h"
 #include "../Mod/RuleItem.h"
 #include <SDL.h>
 #include <string>
@@ -169,6 +170,8 @@ private:
 	bool _endTurnRequested;
 	bool _endConfirmationHandled;
 	bool _allEnemiesNeutralized;
+	bool _autoPlay;
+	BattleRecording *_recording;
 
 	SingleRun _endTurnProcessed;
 	SingleRun _triggerProcessed;
@@ -184,6 +187,10 @@ private:
 	std::vector<InfoboxOKState*> _infoboxQueue;
 	/// Shows the infoboxes in the queue (if any).
 	void showInfoBoxQueue();
+	/// Adds the player's input to the battle recording.
+	void recordInput(BattleInputType type, Position pos);
+	/// Plays back a recorded input of the player.
+	void replayInput(const BattleInput &input);
 public:
 	/// is debug mode enabled in the battlescape?
 	static bool _debugPlay;
@@ -271,6 +278,14 @@ public:
 	Mod *getMod();
 	/// Returns whether panic has been handled.
 	bool getPanicHandled() const { return _playerPanicHandled; }
+	/// Sets whether the AI also plays the player side.
+	void setAutoPlay(bool autoPlay) { _autoPlay = autoPlay; }
+	/// Is a recording being played back for the player?
+	bool isReplaying() const { return _recording && _recording->isReplay(); }
+	/// Records the end of turn requested by the player.
+	void recordEndTurn();
+	/// Ends the battle recording or replay.
+	void finishRecording();
 	/// Tries to find an item and pick it up if possible.
 	bool findItem(BattleAction *action, bool pickUpWeaponsMoreActively);
 	/// Checks through all the items on the ground and picks one.
@@ -784,6 +784,71 @@ void BattlescapeGenerator::run()
 	_save->getTileEngine()->calculateLighting(LL_AMBIENT, TileEngine::invalid, 0, true);
 }
 
+/**
+ * Queues terrain and unit sprites that battle of landing craft will need for background loading,
+ * called when player is asked to confirm landing, so files are in memory before map and units are created.
+ * @param mod Mod with all resources.
+ * @param craft Craft that is landing.
+ */
+void BattlescapeGenerator::prefetchResources(Mod *mod, Craft *craft)
+{
+	auto prefetchTerrain = [](RuleTerrain *terrain)
+	{
+		if (terrain)
+		{
+			for (auto* data : *terrain->getMapDataSets())
+			{
+				data->prefetchData();
+			}
+		}
+	};
+	auto prefetchArmor = [mod](Armor *armor)
+	{
+		if (armor)
+		{
+			mod->prefetchSurface(armor->getSpriteSheet());
+			mod->prefetchSurface(armor->getSpriteInventory());
+		}
+	};
+
+	prefetchTerrain(craft->getRules()->getBattlescapeTerrainData());
+	for (auto* soldier : *craft->getBase()->getSoldiers())
+	{
+		if (soldier->getCraft() == craft)
+		{
+			prefetchArmor(soldier->getArmor());
+		}
+	}
+
+	// map terrain and underwater races are picked later by deployment, only the obvious part is known here
+	std::string raceName;
+	if (Ufo *ufo = dynamic_cast<Ufo*>(craft->getDestination()))
+	{
+		prefetchTerrain(ufo->getRules()->getBattlescapeTerrainData());
+		raceName = ufo->getAlienRace();
+	}
+	else if (MissionSite *site = dynamic_cast<MissionSite*>(craft->getDestination()))
+	{
+		raceName = site->getAlienRace();
+	}
+	else if (AlienBase *base = dynamic_cast<AlienBase*>(craft->getDestination()))
+	{
+		raceName = base->getAlienRace();
+	}
+	AlienRace *race = mod->getAlienRace(raceName);
+	if (race)
+	{
+		for (int i = 0; i < race->getMembers(); ++i)
+		{
+			Unit *unit = mod->getUnit(race->getMember(i));
+			if (unit)
+			{
+				prefetchArmor(unit->getArmor());
+			}
+		}
+	}
+}
+
 /**
  * Deploys all the X-COM units and equipment based on the Geoscape base / craft.
  */
@@ -802,9 +867,9 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 	if (_base != 0)
 	{
 		ItemContainer *rememberMe = _save->getBaseStorageItems();
-		for (std::map<std::string, int>::iterator i = _base->getStorageItems()->getContents()->begin(); i != _base->getStorageItems()->getContents()->end(); ++i)
+		for (auto &i : _base->getStorageItems()->getContents())
 		{
-			rememberMe->addItem(i->first, i->second);
+			rememberMe->addItem(i.first, i.second);
 		}
 	}
 
@@ -986,18 +1051,19 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 	if (_craft != 0)
 	{
 		// add items that are in the craft
-		for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
+		for (auto &i : _craft->getItems()->getContents())
 		{
-			if (startingCondition != 0 && !startingCondition->isItemPermitted(i->first, _game->getMod(), _craft))
+			if (startingCondition != 0 && !startingCondition->isItemPermitted(ItemContainer::getItemType(i.first), _game->getMod(), _craft))
 			{
 				// send disabled items back to base
-				_base->getStorageItems()->addItem(i->first, i->second);
+				_base->getStorageItems()->addItem(i.first, i.second);
 			}
 			else
 			{
-				for (int count = 0; count < i->second; count++)
+				RuleItem *rule = _game->getMod()->getItemById(i.first, true);
+				for (int count = 0; count < i.second; count++)
 				{
-					_save->createItemForTile(i->first, _craftInventoryTile);
+					_save->createItemForTile(rule, _craftInventoryTile);
 				}
 			}
 		}
@@ -1008,9 +1074,9 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 		if (_game->getSavedGame()->getMonthsPassed() != -1)
 		{
 			// add items that are in the base
-			for (std::map<std::string, int>::iterator i = _base->getStorageItems()->getContents()->begin(); i != _base->getStorageItems()->getContents()->end();)
+			for (auto i = _base->getStorageItems()->getContents().begin(); i != _base->getStorageItems()->getContents().end();)
 			{
-				RuleItem *rule = _game->getMod()->getItem(i->first, true);
+				RuleItem *rule = _game->getMod()->getItemById(i->first, true);
 				if (
 					// is item allowed in base defense?
 					rule->canBeEquippedBeforeBaseDefense() &&
@@ -1024,9 +1090,9 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 				{
 					for (int count = 0; count < i->second; count++)
 					{
-						_save->createItemForTile(i->first, _craftInventoryTile);
+						_save->createItemForTile(rule, _craftInventoryTile);
 					}
-					std::map<std::string, int>::iterator tmp = i;
+					auto tmp = i;
 					++i;
 					if (!_baseInventory)
 					{
@@ -1044,11 +1110,12 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 		{
 			if ((*c)->getStatus() == "STR_OUT")
 				continue;
-			for (std::map<std::string, int>::iterator i = (*c)->getItems()->getContents()->begin(); i != (*c)->getItems()->getContents()->end(); ++i)
+			for (auto &i : (*c)->getItems()->getContents())
 			{
-				for (int count = 0; count < i->second; count++)
+				RuleItem *rule = _game->getMod()->getItemById(i.first, true);
+				for (int count = 0; count < i.second; count++)
 				{
-					_save->createItemForTile(i->first, _craftInventoryTile);
+					_save->createItemForTile(rule, _craftInventoryTile);
 				}
 			}
 		}
@@ -1195,6 +1262,7 @@ BattleUnit *BattlescapeGenerator::addXCOMUnit(BattleUnit *unit)
 		if (unit->hasInventory())
 		{
 			_save->getUnits()->push_back(unit);
+			_save->invalidateUnitIndex();
 			_save->initUnit(unit);
 			return unit;
 		}
@@ -1210,6 +1278,7 @@ BattleUnit *BattlescapeGenerator::addXCOMUnit(BattleUnit *unit)
 				_craftInventoryTile = _save->getTile(node->getPosition());
 				unit->setDirection(RNG::generate(0, 7));
 				_save->getUnits()->push_back(unit);
+				_save->invalidateUnitIndex();
 				_save->initUnit(unit);
 				return unit;
 			}
@@ -1220,6 +1289,7 @@ BattleUnit *BattlescapeGenerator::addXCOMUnit(BattleUnit *unit)
 					_craftInventoryTile = _save->getTile(unit->getPosition());
 					unit->setDirection(RNG::generate(0, 7));
 					_save->getUnits()->push_back(unit);
+					_save->invalidateUnitIndex();
 					_save->initUnit(unit);
 					return unit;
 				}
@@ -1255,6 +1325,7 @@ BattleUnit *BattlescapeGenerator::addXCOMUnit(BattleUnit *unit)
 					if (_save->setUnitPosition(unit, pos))
 					{
 						_save->getUnits()->push_back(unit);
+						_save->invalidateUnitIndex();
 						_save->initUnit(unit);
 						unit->setDirection(dir);
 						return unit;
@@ -1272,6 +1343,7 @@ BattleUnit *BattlescapeGenerator::addXCOMUnit(BattleUnit *unit)
 					{
 						_save->initUnit(unit);
 						_save->getUnits()->push_back(unit);
+						_save->invalidateUnitIndex();
 						return unit;
 					}
 				}
@@ -1465,6 +1537,7 @@ BattleUnit *BattlescapeGenerator::addAlien(Unit *rules, int alienRank, bool outs
 		// we only add a unit if it has a node to spawn on.
 		// (stops them spawning at 0,0,0)
 		_save->getUnits()->push_back(unit);
+		_save->invalidateUnitIndex();
 	}
 	else
 	{
@@ -1483,6 +1556,7 @@ BattleUnit *BattlescapeGenerator::addAlien(Unit *rules, int alienRank, bool outs
 				unit->setDirection(RNG::generate(0,7));
 
 			_save->getUnits()->push_back(unit);
+			_save->invalidateUnitIndex();
 		}
 		else
 		{
@@ -1513,12 +1587,14 @@ BattleUnit *BattlescapeGenerator::addCivilian(Unit *rules, int nodeRank)
 		// we only add a unit if it has a node to spawn on.
 		// (stops them spawning at 0,0,0)
 		_save->getUnits()->push_back(unit);
+		_save->invalidateUnitIndex();
 	}
 	else if (placeUnitNearFriend(unit))
 	{
 		unit->setAIModule(new AIModule(_save, unit, node));
 		unit->setDirection(RNG::generate(0,7));
 		_save->getUnits()->push_back(unit);
+		_save->invalidateUnitIndex();
 	}
 	else
 	{
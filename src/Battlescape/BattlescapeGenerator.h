@@ -196,6 +196,8 @@ public:
 	// Auto-equip a set of units
 	static void autoEquip(std::vector<BattleUnit*> units, Mod *mod, std::vector<BattleItem*> *craftInv,
 		RuleInventory *groundRuleInv, int worldShade, bool allowAutoLoadout, bool overrideEquipmentLayout);
+	/// Queues resources needed by the battle of landing craft for background loading.
+	static void prefetchResources(Mod *mod, Craft *craft);
 };
 
 }
@@ -0,0 +1,419 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattlescapeSimulation.h"
+#include <climits>
+#include <sstream>
+#include "AIModule.h"
+#include "BattleRecording.h"
+#include "BattlescapeGame.h"
+#include "BattlescapeState.h"
+#include "NextTurnState.h"
+#include "TileEngine.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Engine/RNG.h"
+#include "../Engine/Script.h"
+#include "../Engine/Timer.h"
+#include "../Mod/Mod.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SavedGame.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Number of logic steps after which a turn is ended by force.
+const int MaxStepsPerTurn = 200000;
+
+/// Names of the profiled parts.
+const char *PartNames[BPP_MAX] = { "AI", "pathfinding", "FOV", "reaction fire", "scripts" };
+
+/// Gets the time since a point in nanoseconds.
+long long since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Profile totals at some point of the simulation.
+struct Snapshot
+{
+	long long part[BPP_MAX];
+
+	Snapshot()
+	{
+		for (int i = 0; i < BPP_MAX; ++i)
+		{
+			part[i] = BattleProfileScope::get((BattleProfilePart)i);
+		}
+	}
+};
+
+/**
+ * Logs the split of a period of the simulation.
+ * @param title Name of the period.
+ * @param total Total time of the period in nanoseconds.
+ * @param begin Profile at the start of the period.
+ * @param end Profile at the end of the period.
+ */
+void logSplit(const std::string &title, long long total, const Snapshot &begin, const Snapshot &end)
+{
+	std::ostringstream ss;
+	long long other = total;
+	ss << title << ": " << total / 1000 << " us";
+	for (int i = 0; i < BPP_MAX; ++i)
+	{
+		long long part = end.part[i] - begin.part[i];
+		other -= part;
+		ss << ", " << PartNames[i] << " " << part / 1000 << " us";
+	}
+	ss << ", other " << other / 1000 << " us";
+	Log(LOG_INFO) << ss.str();
+}
+
+}
+
+bool BattleProfileScope::_enabled = false;
+int BattleProfileScope::_current = -1;
+std::chrono::steady_clock::time_point BattleProfileScope::_since;
+long long BattleProfileScope::_time[BPP_MAX] = { };
+int BattleProfileScope::_scriptDepth = 0;
+int BattleProfileScope::_scriptOuter = -1;
+
+/**
+ * Adds the time since the last change to the current part
+ * and starts timing another one.
+ * @param part Part to time next, or -1 for none.
+ */
+void BattleProfileScope::change(int part)
+{
+	auto now = std::chrono::steady_clock::now();
+	if (_current >= 0)
+	{
+		_time[_current] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - _since).count();
+	}
+	_current = part;
+	_since = now;
+}
+
+/**
+ * Times script runs as their own part, called by the script engine.
+ * Scripts run by other scripts stay in the same part.
+ */
+void BattleProfileScope::beginScript()
+{
+	if (_scriptDepth++ == 0)
+	{
+		_scriptOuter = _current;
+		change(BPP_SCRIPTS);
+	}
+}
+
+/**
+ * Goes back to timing the part that ran the script.
+ */
+void BattleProfileScope::endScript()
+{
+	if (--_scriptDepth == 0)
+	{
+		change(_scriptOuter);
+	}
+}
+
+/**
+ * Turns profiling on or off. Totals are kept.
+ * Scripts are timed only on the calling thread, which must be the main one.
+ * @param enabled Profile the battle logic?
+ */
+void BattleProfileScope::enable(bool enabled)
+{
+	_enabled = enabled;
+	if (enabled)
+	{
+		ScriptWorkerBase::setRunHooks(&beginScript, &endScript);
+	}
+	else
+	{
+		ScriptWorkerBase::setRunHooks(nullptr, nullptr);
+	}
+}
+
+/**
+ * Initializes a simulation.
+ * @param game Pointer to the core game.
+ */
+BattlescapeSimulation::BattlescapeSimulation(Game *game) : _game(game), _battle(0)
+{
+}
+
+/**
+ * Stops profiling and makes sure the simulated game is never saved on exit.
+ */
+BattlescapeSimulation::~BattlescapeSimulation()
+{
+	BattleProfileScope::enable(false);
+	if (_game->getSavedGame())
+	{
+		_game->getSavedGame()->setIronman(false);
+	}
+}
+
+/**
+ * Gives every unit with a side an AI that attacks the other side,
+ * including the player's units and units that changed sides.
+ */
+void BattlescapeSimulation::assignTargets()
+{
+	SavedBattleGame *save = _game->getSavedGame()->getSavedBattle();
+	for (BattleUnit *unit : *save->getUnits())
+	{
+		if (unit->isOut())
+		{
+			continue;
+		}
+		if (!unit->getAIModule())
+		{
+			if (unit->getFaction() != FACTION_PLAYER)
+			{
+				continue;
+			}
+			unit->setAIModule(new AIModule(save, unit, 0));
+		}
+		unit->getAIModule()->setTargetFaction(unit->getFaction() == FACTION_HOSTILE ? FACTION_PLAYER : FACTION_HOSTILE);
+	}
+}
+
+/**
+ * Closes popups and any state pushed on top of the battle
+ * (info boxes, saves) without running them. Next turn screens
+ * are closed as by the player, as that runs the end of turn
+ * and can finish the battle.
+ */
+void BattlescapeSimulation::resolve()
+{
+	for (State *popup : _battle->_popups)
+	{
+		delete popup;
+	}
+	_battle->_popups.clear();
+	while (_game->hasState(_battle) && !_game->isState(_battle))
+	{
+		NextTurnState *nextTurn = dynamic_cast<NextTurnState*>(_game->getTopState());
+		if (nextTurn)
+		{
+			nextTurn->close();
+		}
+		else
+		{
+			_game->popState();
+		}
+	}
+}
+
+/**
+ * Checks if the battle is over, either by the game itself
+ * or because one side has no units left.
+ * @return True if the battle is finished.
+ */
+bool BattlescapeSimulation::isFinished() const
+{
+	if (!_game->hasState(_battle))
+	{
+		return true;
+	}
+	BattlescapeGame *battleGame = _battle->getBattleGame();
+	BattlescapeTally tally = battleGame->tallyUnits();
+	return tally.liveAliens == 0 || tally.liveSoldiers == 0 || battleGame->areAllEnemiesNeutralized();
+}
+
+/**
+ * Loads a save and opens its battle on top of the current state.
+ * @param filename Name of the save in the user folder.
+ * @return True if the battle was loaded.
+ */
+bool BattlescapeSimulation::load(const std::string &filename)
+{
+	SavedGame *save = new SavedGame();
+	try
+	{
+		save->load(filename, _game->getMod(), _game->getLanguage());
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << "Simulation: " << e.what();
+		delete save;
+		return false;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << "Simulation: " << e.what();
+		delete save;
+		return false;
+	}
+	_game->setSavedGame(save);
+	SavedBattleGame *battleSave = save->getSavedBattle();
+	if (battleSave == 0)
+	{
+		Log(LOG_ERROR) << "Simulation: " << filename << " has no battle";
+		return false;
+	}
+
+	battleSave->loadMapResources(_game->getMod());
+	_battle = new BattlescapeState;
+	_game->pushState(_battle);
+	battleSave->setBattleState(_battle);
+	_battle->init();
+	resolve();
+	return true;
+}
+
+/**
+ * Runs the loaded battle for a number of turns, logging the time
+ * taken by each turn. Stops early when the battle is over, or when
+ * a replay runs out of recorded input.
+ * @param title Name of the simulation in the log.
+ * @param turns Number of turns to simulate.
+ */
+void BattlescapeSimulation::play(const std::string &title, int turns)
+{
+	SavedBattleGame *battleSave = _game->getSavedGame()->getSavedBattle();
+	BattlescapeGame *battleGame = _battle->getBattleGame();
+	bool replay = battleGame->isReplaying();
+	BattleProfileScope::enable(true);
+
+	const Snapshot first;
+	Snapshot turnBegin;
+	auto start = std::chrono::steady_clock::now();
+	auto turnStart = start;
+	int turn = battleSave->getTurn();
+	UnitFaction side = battleSave->getSide();
+	int done = 0, steps = 0;
+	while (done < turns && _game->hasState(_battle) && (replay ? battleGame->isReplaying() : !isFinished()))
+	{
+		battleGame->think();
+		battleGame->handleState();
+		if (!_game->hasState(_battle))
+		{
+			break;
+		}
+		resolve();
+		if (!_game->hasState(_battle))
+		{
+			break; // the end of turn finished the battle
+		}
+
+		if (battleSave->getSide() != side)
+		{
+			side = battleSave->getSide();
+			steps = 0;
+			if (!replay)
+			{
+				assignTargets();
+			}
+		}
+		else if (++steps == MaxStepsPerTurn)
+		{
+			Log(LOG_WARNING) << "Simulation: turn " << turn << " got stuck, ending it";
+			battleGame->requestEndTurn(false);
+		}
+		if (battleSave->getTurn() != turn)
+		{
+			Snapshot turnEnd;
+			logSplit("Turn " + std::to_string(turn), since(turnStart), turnBegin, turnEnd);
+			turnBegin = turnEnd;
+			turnStart = std::chrono::steady_clock::now();
+			turn = battleSave->getTurn();
+			++done;
+		}
+	}
+	long long total = since(start);
+	BattleProfileScope::enable(false);
+
+	if (isFinished())
+	{
+		Log(LOG_INFO) << "Simulation: battle ended after " << done << " turns";
+	}
+	logSplit(title + ", " + std::to_string(done) + " turns", total, first, Snapshot());
+}
+
+/**
+ * Loads a saved battle and lets the AI play all sides for
+ * a number of turns, logging the time taken by each turn.
+ * @param filename Name of the save in the user folder.
+ * @param turns Number of turns to simulate.
+ * @param seed Seed for the random generator.
+ * @return True if the battle was loaded and no batched line
+ * differed from the same line traced alone (see verifyLineBatch).
+ */
+bool BattlescapeSimulation::run(const std::string &filename, int turns, unsigned long long seed)
+{
+	if (!load(filename))
+	{
+		return false;
+	}
+	_battle->getBattleGame()->setAutoPlay(true);
+	RNG::setSeed(seed);
+	assignTargets();
+
+	Log(LOG_INFO) << "Simulating " << turns << " turns of " << filename << " with seed " << seed;
+	play("Simulated " + filename, turns);
+	if (TileEngine::getLineBatchMismatches() > 0)
+	{
+		Log(LOG_ERROR) << "Simulation: " << TileEngine::getLineBatchMismatches() << " batched lines differ from single lines";
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Loads a battle recording and its save, and plays the recorded
+ * input back for the player until it runs out, logging the time
+ * taken by each turn and the checksum of the final state.
+ * @param name Name of the recording in the user folder.
+ * @return True if the recording was loaded and the replay matched it.
+ */
+bool BattlescapeSimulation::replay(const std::string &name)
+{
+	BattleRecording *recording = new BattleRecording(name, true);
+	if (!recording->load())
+	{
+		delete recording;
+		return false;
+	}
+	BattleRecording::setPendingReplay(recording);
+	if (!load(recording->getSaveName()))
+	{
+		BattleRecording::setPendingReplay(0);
+		return false;
+	}
+
+	Log(LOG_INFO) << "Replaying " << name;
+	int mismatches = BattleRecording::getReplayMismatches();
+	play("Replayed " + name, INT_MAX);
+	if (_game->hasState(_battle))
+	{
+		_battle->getBattleGame()->finishRecording();
+	}
+	return BattleRecording::getReplayMismatches() == mismatches;
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <string>
+
+namespace OpenXcom
+{
+
+class Game;
+class BattlescapeState;
+
+/// Parts of the battle logic timed by the battle simulation.
+enum BattleProfilePart { BPP_AI, BPP_PATHFINDING, BPP_FOV, BPP_REACTION, BPP_SCRIPTS, BPP_MAX };
+
+/**
+ * Adds the time spent in a scope to a part of the battle profile,
+ * while the battle simulation is profiling. A nested scope pauses
+ * the outer one, so each nanosecond is counted in one part only.
+ * Only for the main thread.
+ */
+class BattleProfileScope
+{
+private:
+	static bool _enabled;
+	static int _current;
+	static std::chrono::steady_clock::time_point _since;
+	static long long _time[BPP_MAX];
+	static int _scriptDepth, _scriptOuter;
+	int _outer;
+	bool _active;
+
+	/// Switches the timed part.
+	static void change(int part);
+	/// Starts timing a script run.
+	static void beginScript();
+	/// Stops timing a script run.
+	static void endScript();
+public:
+	/// Starts timing a part.
+	BattleProfileScope(BattleProfilePart part) : _outer(_current), _active(_enabled)
+	{
+		if (_active) change(part);
+	}
+	/// Goes back to timing the outer part.
+	~BattleProfileScope()
+	{
+		if (_active) change(_outer);
+	}
+	/// Turns profiling on or off.
+	static void enable(bool enabled);
+	/// Gets the total time of a part in nanoseconds.
+	static long long get(BattleProfilePart part) { return _time[part]; }
+};
+
+/**
+ * Plays a saved battle with the AI on every side, or a battle
+ * recording, without drawing or waiting for animations, and logs
+ * how long each turn took.
+ * Anything that would wait for the player (info boxes, saves)
+ * is closed without running, next turn screens are closed as by
+ * the player, so the end of turn logic and the end of battle run.
+ */
+class BattlescapeSimulation
+{
+private:
+	Game *_game;
+	BattlescapeState *_battle;
+
+	/// Gets every unit's AI to attack the other side.
+	void assignTargets();
+	/// Closes everything waiting for the player.
+	void resolve();
+	/// Checks if the battle is over.
+	bool isFinished() const;
+	/// Loads a save and opens its battle.
+	bool load(const std::string &filename);
+	/// Runs the open battle for a number of turns.
+	void play(const std::string &title, int turns);
+public:
+	/// Creates a simulation.
+	BattlescapeSimulation(Game *game);
+	/// Cleans up the simulation.
+	~BattlescapeSimulation();
+	/// Loads a saved battle and simulates it for a number of turns.
+	bool run(const std::string &filename, int turns, unsigned long long seed);
+	/// Loads a battle recording and plays it back.
+	bool replay(const std::string &name);
+};
+
+}
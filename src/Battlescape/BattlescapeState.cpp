@@ -776,6 +776,8 @@ void BattlescapeState::think()
 {
 	static bool popped = false;
 
+	SaveGameState::showBackgroundErrors(OPT_BATTLESCAPE, _palette);
+
 	if (_gameTimer->isRunning())
 	{
 		if (_popups.empty())
@@ -1295,6 +1297,7 @@ void BattlescapeState::btnEndTurnClick(Action *)
 	if (allowButtons())
 	{
 		_txtTooltip->setText("");
+		_battleGame->recordEndTurn();
 		_battleGame->requestEndTurn(false);
 	}
 }
@@ -2942,6 +2945,7 @@ void BattlescapeState::popup(State *state)
  */
 void BattlescapeState::finishBattle(bool abort, int inExitArea)
 {
+	_battleGame->finishRecording();
 	while (!_game->isState(this))
 	{
 		_game->popState();
@@ -46,6 +46,7 @@ class BattlescapeGame;
  */
 class BattlescapeState : public State
 {
+	friend class BattlescapeSimulation;
 
 enum ButtonType { BTN_PSI, BTN_SPECIAL, BTN_SKILL };
 
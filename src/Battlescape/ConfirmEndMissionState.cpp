@@ -108,6 +108,7 @@ ConfirmEndMissionState::~ConfirmEndMissionState()
 void ConfirmEndMissionState::btnOkClick(Action *)
 {
 	_game->popState();
+	_parent->recordEndTurn();
 	_parent->requestEndTurn(false);
 }
 
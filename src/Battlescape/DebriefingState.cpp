@@ -23,6 +23,7 @@
 #include "CannotReequipState.h"
 #include "../Engine/Action.h"
 #include "../Engine/Game.h"
+#include "../Engine/AsyncLoader.h"
 #include "../Engine/LocalizedText.h"
 #include "../Interface/TextButton.h"
 #include "../Interface/Text.h"
@@ -90,6 +91,12 @@ DebriefingState::DebriefingState() : _region(0), _country(0), _positiveScore(tru
 
 	// Restore the cursor in case something weird happened
 	_game->getCursor()->setVisible(true);
+
+	// Battle is over, its sprites that were never shown are not needed anymore
+	if (AsyncLoader *loader = AsyncLoader::findShared())
+	{
+		loader->evict();
+	}
 	_limitsEnforced = Options::storageLimitsEnforced ? 1 : 0;
 
 	// Create objects
@@ -2113,8 +2120,8 @@ void DebriefingState::prepareDebriefing()
  */
 void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCanBeDestroyed)
 {
-	std::map<std::string, int> craftItems = *craft->getItems()->getContents();
-	for (std::map<std::string, int>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
+	std::map<int, int> craftItems = craft->getItems()->getContents();
+	for (std::map<int, int>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
 	{
 		int qty = base->getStorageItems()->getItem(i->first);
 		if (qty >= i->second)
@@ -2126,7 +2133,7 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 			int missing = i->second - qty;
 			base->getStorageItems()->removeItem(i->first, qty);
 			craft->getItems()->removeItem(i->first, missing);
-			ReequipStat stat = {i->first, missing, craft->getName(_game->getLanguage()), 0};
+			ReequipStat stat = {ItemContainer::getItemType(i->first), missing, craft->getName(_game->getLanguage()), 0};
 			_missingItems.push_back(stat);
 		}
 	}
@@ -2142,16 +2149,16 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 			delete (*i);
 	craft->getVehicles()->clear();
 	// Ok, now read those vehicles
-	for (std::map<std::string, int>::iterator i = craftVehicles.getContents()->begin(); i != craftVehicles.getContents()->end(); ++i)
+	for (std::map<int, int>::const_iterator i = craftVehicles.getContents().begin(); i != craftVehicles.getContents().end(); ++i)
 	{
 		int qty = base->getStorageItems()->getItem(i->first);
-		RuleItem *tankRule = _game->getMod()->getItem(i->first, true);
+		RuleItem *tankRule = _game->getMod()->getItemById(i->first, true);
 		int size = tankRule->getVehicleUnit()->getArmor()->getTotalSize();
 		int canBeAdded = std::min(qty, i->second);
 		if (qty < i->second)
 		{ // missing tanks
 			int missing = i->second - qty;
-			ReequipStat stat = {i->first, missing, craft->getName(_game->getLanguage()), 0};
+			ReequipStat stat = {tankRule->getType(), missing, craft->getName(_game->getLanguage()), 0};
 			_missingItems.push_back(stat);
 		}
 		if (tankRule->getVehicleClipAmmo() == nullptr)
@@ -882,6 +882,7 @@ BattleUnit* NextTurnState::addReinforcement(const ReinforcementsData &wave, Unit
 				unit->setRankInt(alienRank);
 				unit->setDirection(RNG::generate(0, 7));
 				_battleGame->getUnits()->push_back(unit);
+				_battleGame->invalidateUnitIndex();
 				unitPlaced = true;
 				break;
 			}
@@ -971,6 +972,7 @@ BattleUnit* NextTurnState::addReinforcement(const ReinforcementsData &wave, Unit
 						unit->setRankInt(alienRank);
 						unit->setDirection(RNG::generate(0, 7));
 						_battleGame->getUnits()->push_back(unit);
+						_battleGame->invalidateUnitIndex();
 						unitPlaced = true;
 						break;
 					}
@@ -987,6 +989,7 @@ BattleUnit* NextTurnState::addReinforcement(const ReinforcementsData &wave, Unit
 		unit->setRankInt(alienRank);
 		unit->setDirection(RNG::generate(0, 7));
 		_battleGame->getUnits()->push_back(unit);
+		_battleGame->invalidateUnitIndex();
 		unitPlaced = true;
 	}
 
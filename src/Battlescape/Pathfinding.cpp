@@ -19,7 +19,6 @@
 #include <list>
 #include <algorithm>
 #include "Pathfinding.h"
-#include "PathfindingOpenSet.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Mod/Armor.h"
@@ -27,6 +26,7 @@
 #include "../Engine/Options.h"
 #include "BattlescapeGame.h"
 #include "TileEngine.h"
+#include "BattlescapeSimulation.h"
 
 namespace OpenXcom
 {
@@ -82,6 +82,7 @@ PathfindingNode *Pathfinding::getNode(Position pos)
  */
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *target, int maxTUCost)
 {
+	BattleProfileScope profile(BPP_PATHFINDING);
 	_totalTUCost = 0;
 	_path.clear();
 	// i'm DONE with these out of bounds errors.
@@ -166,13 +167,14 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
 bool Pathfinding::aStarPath(Position startPosition, Position endPosition, BattleUnit *target, bool sneak, int maxTUCost)
 {
 	// reset every node, so we have to check them all
+	_openSet.clear();
 	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
 		it->reset();
 
 	// start position is the first one in our "open" list
 	PathfindingNode *start = getNode(startPosition);
 	start->connect(0, 0, 0, endPosition);
-	PathfindingOpenSet openList;
+	PathfindingOpenSet &openList = _openSet;
 	openList.push(start);
 	bool missile = (target && maxTUCost == 10000);
 	// if the open list is empty, we've reached the end
@@ -1138,24 +1140,49 @@ bool Pathfinding::bresenhamPath(Position origin, Position target, BattleUnit *ta
 }
 
 /**
- * Locates all tiles reachable to @a *unit with a TU cost no more than @a tuMax.
- * Uses Dijkstra's algorithm.
+ * Gets the largest path cost a unit can spend and still afford an action afterwards.
+ * Walking costs half of the path cost in energy, so the energy left limits the path cost too.
  * @param unit Pointer to the unit.
- * @param tuMax The maximum cost of the path to each tile.
- * @return An array of reachable tiles, sorted in ascending order of cost. The first tile is the start location.
+ * @param cost The cost of the action to do at the end of the path.
+ * @return The largest allowed path cost.
  */
-std::vector<int> Pathfinding::findReachable(BattleUnit *unit, const BattleActionCost &cost)
+int Pathfinding::getReachableLimit(BattleUnit *unit, const BattleActionCost &cost) const
 {
-	const Position start = unit->getPosition();
 	int tuMax = unit->getTimeUnits() - cost.Time;
 	int energyMax = unit->getEnergy() - cost.Energy;
+	return std::min(tuMax, 2 * energyMax + 1);
+}
+
+/**
+ * Gets the cost of reaching every tile @a *unit can walk to with a path cost no more than @a limit.
+ * Uses Dijkstra's algorithm, or the result of an earlier search if the map and units haven't changed since.
+ * @param unit Pointer to the unit.
+ * @param limit The maximum cost of the path to each tile.
+ * @return The reachable tiles, sorted in ascending order of cost.
+ */
+const ReachabilityCache::Field &Pathfinding::getReachableField(BattleUnit *unit, int limit)
+{
+	setUnit(unit);
+	const Position start = unit->getPosition();
+	const int startIndex = _save->getTileIndex(start);
+	ReachabilityCache *cache = _save->getReachabilityCache();
+	const size_t unitsStamp = cache->getUnitsStamp(*_save->getUnits(), unit);
+	const ReachabilityCache::Field *cached = cache->find(unit, startIndex, _movementType, limit, unitsStamp);
+	if (cached)
+	{
+		return *cached;
+	}
+
+	// search as far as the unit could ever walk, so later questions with smaller budgets can reuse the result
+	const int searchLimit = std::max(limit, getReachableLimit(unit, BattleActionCost()));
+	_openSet.clear();
 	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
 	{
 		it->reset();
 	}
 	PathfindingNode *startNode = getNode(start);
 	startNode->connect(0, 0, 0);
-	PathfindingOpenSet unvisited;
+	PathfindingOpenSet &unvisited = _openSet;
 	unvisited.push(startNode);
 	std::vector<PathfindingNode*> reachable;
 	while (!unvisited.empty())
@@ -1170,8 +1197,7 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, const BattleAction
 			int tuCost = getTUCost(currentPos, direction, &nextPos, unit, 0, false);
 			if (tuCost == 255) // Skip unreachable / blocked
 				continue;
-			if (currentNode->getTUCost(false) + tuCost > tuMax ||
-				(currentNode->getTUCost(false) + tuCost) / 2 > energyMax) // Run out of TUs/Energy
+			if (currentNode->getTUCost(false) + tuCost > searchLimit) // Run out of TUs/Energy
 				continue;
 			PathfindingNode *nextNode = getNode(nextPos);
 			if (nextNode->isChecked()) // Our algorithm means this node is already at minimum cost.
@@ -1188,15 +1214,70 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, const BattleAction
 		reachable.push_back(currentNode);
 	}
 	std::sort(reachable.begin(), reachable.end(), MinNodeCosts());
-	std::vector<int> tiles;
-	tiles.reserve(reachable.size());
+	ReachabilityCache::Field field;
+	field.limit = searchLimit;
+	field.tiles.reserve(reachable.size());
+	field.costs.reserve(reachable.size());
+	field.costByTile.reserve(reachable.size());
 	for (std::vector<PathfindingNode*>::const_iterator it = reachable.begin(); it != reachable.end(); ++it)
 	{
-		tiles.push_back(_save->getTileIndex((*it)->getPosition()));
+		int index = _save->getTileIndex((*it)->getPosition());
+		int tuCost = (*it)->getTUCost(false);
+		field.tiles.push_back(index);
+		field.costs.push_back(tuCost);
+		field.costByTile[index] = tuCost;
+	}
+	return *cache->store(unit, startIndex, _movementType, unitsStamp, std::move(field));
+}
+
+/**
+ * Locates all tiles reachable to @a *unit with enough TUs and energy left for an action.
+ * @param unit Pointer to the unit.
+ * @param cost The cost of the action to do at the end of the path.
+ * @return An array of reachable tiles, sorted in ascending order of cost. The first tile is the start location.
+ */
+std::vector<int> Pathfinding::findReachable(BattleUnit *unit, const BattleActionCost &cost)
+{
+	BattleProfileScope profile(BPP_PATHFINDING);
+	const int limit = getReachableLimit(unit, cost);
+	const ReachabilityCache::Field &field = getReachableField(unit, limit);
+	const int startIndex = _save->getTileIndex(unit->getPosition());
+	std::vector<int> tiles;
+	tiles.reserve(field.tiles.size());
+	for (size_t i = 0; i < field.tiles.size() && field.costs[i] <= std::max(limit, 0); ++i)
+	{
+		// the start location is always reachable, even if the action itself can't be afforded
+		if (field.costs[i] <= limit || field.tiles[i] == startIndex)
+		{
+			tiles.push_back(field.tiles[i]);
+		}
 	}
 	return tiles;
 }
 
+/**
+ * Checks if @a *unit can walk to a tile and still afford an action there.
+ * Same as looking for the tile in the result of findReachable(), without building the list.
+ * @param unit Pointer to the unit.
+ * @param cost The cost of the action to do at the end of the path.
+ * @param pos The position to reach.
+ * @return True if the tile is reachable.
+ */
+bool Pathfinding::isReachable(BattleUnit *unit, const BattleActionCost &cost, Position pos)
+{
+	if (_save->getTile(pos) == 0)
+	{
+		return false;
+	}
+	if (pos == unit->getPosition())
+	{
+		return true;
+	}
+	const int limit = getReachableLimit(unit, cost);
+	const int tuCost = getReachableField(unit, limit).getCost(_save->getTileIndex(pos));
+	return tuCost != -1 && tuCost <= limit;
+}
+
 /**
  * Gets the strafe move setting.
  * @return Strafe move.
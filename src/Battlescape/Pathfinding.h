@@ -20,7 +20,9 @@
 #include <vector>
 #include "Position.h"
 #include "PathfindingNode.h"
+#include "PathfindingOpenSet.h"
 #include "../Mod/MapData.h"
+#include "../Savegame/ReachabilityCache.h"
 
 namespace OpenXcom
 {
@@ -43,6 +45,8 @@ private:
 
 	SavedBattleGame *_save;
 	std::vector<PathfindingNode> _nodes;
+	/// Open set shared by all searches, so its storage is reused between calls.
+	PathfindingOpenSet _openSet;
 	int _size;
 	BattleUnit *_unit;
 	bool _pathPreviewed;
@@ -62,6 +66,10 @@ private:
 	bool canFallDown(Tile *destinationTile) const;
 	/// Determines whether a unit can fall down from this tile.
 	bool canFallDown(Tile *destinationTile, int size) const;
+	/// Gets the largest path cost that leaves enough TUs and energy for an action.
+	int getReachableLimit(BattleUnit *unit, const BattleActionCost &cost) const;
+	/// Gets the cost of reaching all tiles within a path cost limit.
+	const ReachabilityCache::Field &getReachableField(BattleUnit *unit, int limit);
 	std::vector<int> _path;
 public:
 	/// Determines whether the unit is going up a stairs.
@@ -131,6 +139,8 @@ public:
 	void setUnit(BattleUnit *unit);
 	/// Gets all reachable tiles, based on cost.
 	std::vector<int> findReachable(BattleUnit *unit, const BattleActionCost &cost);
+	/// Checks if a tile is reachable, based on cost.
+	bool isReachable(BattleUnit *unit, const BattleActionCost &cost, Position pos);
 	/// Gets _totalTUCost; finds out whether we can hike somewhere in this turn or not.
 	int getTotalTUCost() const { return _totalTUCost; }
 	/// Gets the path preview setting.
@@ -24,29 +24,88 @@ namespace OpenXcom
 {
 
 /**
- * Cleans up all the entries still in set.
+ * Gets the value the set is ordered by.
+ * @param node A pointer to the node.
+ * @return The known cost plus the estimated remaining cost.
  */
-PathfindingOpenSet::~PathfindingOpenSet()
+int PathfindingOpenSet::getCost(const PathfindingNode *node)
 {
-	while (!_queue.empty())
+	return node->getTUCost(false) + node->getTUGuess();
+}
+
+/**
+ * Stores the entry at the given heap position and updates the back reference of its node.
+ * @param index The heap position.
+ * @param entry The entry.
+ */
+void PathfindingOpenSet::place(int index, const Entry &entry)
+{
+	_heap[index] = entry;
+	entry.node->_openIndex = index;
+}
+
+/**
+ * Moves the node at the given position towards the top of the heap
+ * while it is cheaper than its parent.
+ * @param index The heap position.
+ */
+void PathfindingOpenSet::siftUp(int index)
+{
+	const Entry entry = _heap[index];
+	while (index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if (_heap[parent].cost <= entry.cost)
+		{
+			break;
+		}
+		place(index, _heap[parent]);
+		index = parent;
+	}
+	place(index, entry);
+}
+
+/**
+ * Moves the node at the given position towards the bottom of the heap
+ * while any of its children is cheaper.
+ * @param index The heap position.
+ */
+void PathfindingOpenSet::siftDown(int index)
+{
+	const int size = (int)_heap.size();
+	const Entry entry = _heap[index];
+	while (true)
 	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
+		int child = 2 * index + 1;
+		if (child >= size)
+		{
+			break;
+		}
+		if (child + 1 < size && _heap[child + 1].cost < _heap[child].cost)
+		{
+			++child;
+		}
+		if (entry.cost <= _heap[child].cost)
+		{
+			break;
+		}
+		place(index, _heap[child]);
+		index = child;
 	}
+	place(index, entry);
 }
 
 /**
- * Keeps removing all discarded entries that have come to the top of the queue.
+ * Removes all nodes from the set.
+ * The storage is kept, so the set can be reused by the next search without allocating.
  */
-void PathfindingOpenSet::removeDiscarded()
+void PathfindingOpenSet::clear()
 {
-	while (!_queue.empty() && !_queue.top()->_node)
+	for (const Entry &entry : _heap)
 	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
+		entry.node->_openIndex = -1;
 	}
+	_heap.clear();
 }
 
 /**
@@ -57,32 +116,37 @@ void PathfindingOpenSet::removeDiscarded()
 PathfindingNode *PathfindingOpenSet::pop()
 {
 	assert(!empty());
-	OpenSetEntry *entry = _queue.top();
-	PathfindingNode *nd = entry->_node;
-	_queue.pop();
-	delete entry;
-	nd->_openentry = 0;
-
-	// Discarded entries might be visible now.
-	removeDiscarded();
+	PathfindingNode *nd = _heap.front().node;
+	const Entry last = _heap.back();
+	_heap.pop_back();
+	if (!_heap.empty())
+	{
+		place(0, last);
+		siftDown(0);
+	}
+	nd->_openIndex = -1;
 	return nd;
 }
 
 /**
  * Places the node in the set.
- * If the node was already in the set, the previous entry is discarded.
+ * If the node was already in the set, its position is updated to match the new cost.
  * It is the caller's responsibility to never re-add a node with a worse cost.
  * @param node A pointer to the node to add.
  */
 void PathfindingOpenSet::push(PathfindingNode *node)
 {
-	OpenSetEntry *entry = new OpenSetEntry;
-	entry->_node = node;
-	entry->_cost = node->getTUCost(false) + node->getTUGuess();
-	if (node->_openentry)
-		node->_openentry->_node = 0;
-	node->_openentry = entry;
-	_queue.push(entry);
+	if (node->_openIndex < 0)
+	{
+		node->_openIndex = (int)_heap.size();
+		_heap.push_back(Entry{ getCost(node), node });
+	}
+	else
+	{
+		assert(_heap[node->_openIndex].node == node);
+		_heap[node->_openIndex].cost = getCost(node);
+	}
+	siftUp(node->_openIndex);
 }
 
 
@@ -17,57 +17,48 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <queue>
+#include <vector>
 
 namespace OpenXcom
 {
 
 class PathfindingNode;
 
-struct OpenSetEntry
-{
-	int _cost;
-	PathfindingNode *_node;
-};
-
-/**
- * Helper class to compare entries through pointers.
- */
-class EntryCompare
-{
-public:
-	/**
-	 * Compares entries @a *a and @a *b.
-	 * @param a Pointer to first entry.
-	 * @param b Pointer to second entry.
-	 * @return True if entry @a *b must come before @a *a.
-	 */
-	bool operator()(OpenSetEntry *a, OpenSetEntry *b) const
-	{
-		return b->_cost < a->_cost;
-	}
-};
-
 /**
  * A class that holds references to the nodes to be examined in pathfinding.
+ * Implemented as a binary heap indexed from the nodes themselves,
+ * so lowering the cost of a node already in the set is done in place
+ * and no memory is allocated once the storage has grown to the working size.
  */
 class PathfindingOpenSet
 {
 public:
-	/// Cleans up the set and frees allocated memory.
-	~PathfindingOpenSet();
 	/// Gets the next node to check.
 	PathfindingNode *pop();
 	/// Adds a node to the set.
 	void push(PathfindingNode *node);
 	/// Is the set empty?
-	bool empty() const { return _queue.empty(); }
+	bool empty() const { return _heap.empty(); }
+	/// Removes all nodes from the set, keeping the allocated storage.
+	void clear();
 
 private:
-	std::priority_queue<OpenSetEntry*, std::vector<OpenSetEntry*>, EntryCompare> _queue;
+	/// Heap entry, with the key next to the node so comparisons don't touch the nodes.
+	struct Entry
+	{
+		int cost;
+		PathfindingNode *node;
+	};
+	std::vector<Entry> _heap;
 
-	/// Removes reachable discarded entries.
-	void removeDiscarded();
+	/// Gets the heap key of a node.
+	static int getCost(const PathfindingNode *node);
+	/// Stores an entry at a heap position.
+	void place(int index, const Entry &entry);
+	/// Moves a node up the heap until the heap order is restored.
+	void siftUp(int index);
+	/// Moves a node down the heap until the heap order is restored.
+	void siftDown(int index);
 };
 
 }
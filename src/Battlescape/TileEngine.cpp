@@ -25,6 +25,7 @@
 #include "Map.h"
 #include "Camera.h"
 #include "Projectile.h"
+#include "BattlescapeSimulation.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "ExplosionBState.h"
@@ -33,6 +34,7 @@
 #include "../Savegame/BattleUnit.h"
 #include "../Savegame/BattleUnitStatistics.h"
 #include "../Savegame/HitLog.h"
+#include "../Savegame/ReachabilityCache.h"
 #include "../Engine/RNG.h"
 #include "../Engine/GraphSubset.h"
 #include "BattlescapeState.h"
@@ -45,6 +47,7 @@
 #include "Pathfinding.h"
 #include "../Engine/Game.h"
 #include "../Engine/Options.h"
+#include "../Engine/WorkerPool.h"
 #include "ProjectileFlyBState.h"
 #include "MeleeAttackBState.h"
 #include "../fmath.h"
@@ -164,6 +167,131 @@ bool calculateLineHitHelper(const Position& origin, const Position& target, Func
 	return false;
 }
 
+/**
+ * Bresenham line in 3D stepped one voxel at time, visits same voxels in same order as `calculateLineHitHelper`.
+ */
+class LineHitStepper
+{
+	int _x, _x1, _y, _z;
+	int _deltaX, _deltaY, _deltaZ;
+	int _stepX, _stepY, _stepZ;
+	int _driftXY, _driftXZ;
+	bool _swapXY, _swapXZ;
+	int _phase;
+
+	/// Converts line coordinates back to voxel position.
+	Position unswap() const
+	{
+		int cx = _x, cy = _y, cz = _z;
+		if (_swapXZ) std::swap(cx, cz);
+		if (_swapXY) std::swap(cx, cy);
+		return Position(cx, cy, cz);
+	}
+
+public:
+	/// Default constructor, line without any voxels.
+	LineHitStepper() : _x(0), _x1(0), _y(0), _z(0), _deltaX(0), _deltaY(0), _deltaZ(0), _stepX(0), _stepY(0), _stepZ(0), _driftXY(0), _driftXZ(0), _swapXY(false), _swapXZ(false), _phase(3)
+	{
+
+	}
+
+	/// Start new line.
+	void init(const Position& origin, const Position& target)
+	{
+		int x0 = origin.x, x1 = target.x;
+		int y0 = origin.y, y1 = target.y;
+		int z0 = origin.z, z1 = target.z;
+
+		_swapXY = abs(y1 - y0) > abs(x1 - x0);
+		if (_swapXY)
+		{
+			std::swap(x0, y0);
+			std::swap(x1, y1);
+		}
+		_swapXZ = abs(z1 - z0) > abs(x1 - x0);
+		if (_swapXZ)
+		{
+			std::swap(x0, z0);
+			std::swap(x1, z1);
+		}
+
+		_deltaX = abs(x1 - x0);
+		_deltaY = abs(y1 - y0);
+		_deltaZ = abs(z1 - z0);
+
+		_driftXY = (_deltaX / 2);
+		_driftXZ = (_deltaX / 2);
+
+		_stepX = x0 > x1 ? -1 : 1;
+		_stepY = y0 > y1 ? -1 : 1;
+		_stepZ = z0 > z1 ? -1 : 1;
+
+		_x = x0;
+		_x1 = x1;
+		_y = y0;
+		_z = z0;
+		_phase = 0;
+	}
+
+	/// Is whole line visited?
+	bool isFinished() const
+	{
+		return _phase == 3;
+	}
+
+	/**
+	 * Gets next voxel of line.
+	 * @param point Next voxel.
+	 * @return False if line ended.
+	 */
+	bool next(Position& point)
+	{
+		while (true)
+		{
+			switch (_phase)
+			{
+			case 0: // step in primary direction
+				point = unswap();
+				if (_x == _x1)
+				{
+					_phase = 3;
+				}
+				else
+				{
+					_driftXY = _driftXY - _deltaY;
+					_driftXZ = _driftXZ - _deltaZ;
+					_phase = 1;
+				}
+				return true;
+			case 1: // side step in y plane
+				_phase = 2;
+				if (_driftXY < 0)
+				{
+					_y = _y + _stepY;
+					_driftXY = _driftXY + _deltaX;
+					point = unswap();
+					return true;
+				}
+				break;
+			case 2: // side step in z plane
+				_phase = 0;
+				if (_driftXZ < 0)
+				{
+					_z = _z + _stepZ;
+					_driftXZ = _driftXZ + _deltaX;
+					point = unswap();
+					_x = _x + _stepX;
+					return true;
+				}
+				_x = _x + _stepX;
+				break;
+			default:
+				return false;
+			}
+		}
+	}
+};
+
 /**
  * Iterate through some subset of map tiles.
  * @param save Map data.
@@ -195,6 +323,35 @@ void iterateTiles(SavedBattleGame* save, MapSubset gs, TileFunc func)
 	}
 }
 
+/**
+ * Split subset of map into bands of rows and process them in parallel.
+ * Each band covers different tiles, so callback can freely change tiles in its own band.
+ * @param save Map data.
+ * @param gs Square subset of map area.
+ * @param func Call back for each band.
+ */
+template<typename BandFunc>
+void iterateBands(SavedBattleGame* save, MapSubset gs, BandFunc func)
+{
+	constexpr int minBandSize = 4;
+
+	gs = MapSubset::intersection(gs, MapSubset{ save->getMapSizeX(), save->getMapSizeY() });
+	if (gs)
+	{
+		auto& pool = WorkerPool::getShared();
+		const int bands = std::max(1, std::min(pool.getSize() + 1, gs.size_y() / minBandSize));
+		pool.parallelFor(bands,
+			[&](int i)
+			{
+				MapSubset band = gs;
+				band.beg_y = gs.beg_y + gs.size_y() * i / bands;
+				band.end_y = gs.beg_y + gs.size_y() * (i + 1) / bands;
+				func(band);
+			}
+		);
+	}
+}
+
 /**
  * Generate square subset of map using position and radius.
  * @param position Starting position.
@@ -219,6 +376,7 @@ constexpr int TileEngine::heightFromCenter[11];
 constexpr Position TileEngine::invalid;
 constexpr Position TileEngine::voxelTileSize;
 constexpr Position TileEngine::voxelTileCenter;
+int TileEngine::_lineBatchMismatches = 0;
 
 /**
  * Sets up a TileEngine.
@@ -236,6 +394,55 @@ TileEngine::TileEngine(SavedBattleGame *save, Mod *mod) :
 {
 	_blockVisibility.resize(save->getMapSizeXYZ());
 	_cacheTilePos = invalid;
+	_cacheTileIndex = -1;
+
+	_voxelBlockIndex.resize(save->getMapSizeXYZ());
+	for (int i = 0; i < save->getMapSizeXYZ(); ++i)
+	{
+		updateVoxelBlock(save->getTile(i), i);
+	}
+}
+
+/**
+ * Rebuilds the static terrain voxel block of a tile.
+ * Tiles with the same set of terrain parts share one block, so the grid stays small
+ * even on big maps and destroyed or opened parts only need a lookup to patch it.
+ * @param tile Tile to update.
+ * @param index Index of the tile in the map.
+ */
+void TileEngine::updateVoxelBlock(Tile *tile, int index)
+{
+	VoxelBlockKey key = { };
+	for (int i = O_FLOOR; i <= O_OBJECT; ++i)
+	{
+		TilePart tp = (TilePart)i;
+		if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
+			continue;
+		key[i] = tile->getMapData(tp);
+	}
+
+	auto it = _voxelBlockLookup.find(key);
+	if (it == _voxelBlockLookup.end())
+	{
+		VoxelBlock block = { };
+		for (const MapData *mp : key)
+		{
+			if (mp == nullptr)
+				continue;
+			for (int layer = 0; layer < 12; ++layer)
+			{
+				int idx = mp->getLoftID(layer) * 16;
+				for (int y = 0; y < 16; ++y)
+				{
+					block.rows[layer][y] |= _voxelData->at(idx + y);
+				}
+			}
+		}
+		_voxelBlocks.push_back(block);
+		it = _voxelBlockLookup.emplace(key, (Uint32)(_voxelBlocks.size() - 1)).first;
+	}
+	_voxelBlockIndex[index] = it->second;
+	tile->clearVoxelDirty();
 }
 
 /**
@@ -253,9 +460,9 @@ void TileEngine::calculateSunShading(MapSubset gs)
 {
 	int power = 15 - _save->getGlobalShade();
 
-	iterateTiles(
+	iterateBands(_save, gs, [&](MapSubset band){ iterateTiles(
 		_save,
-		gs,
+		band,
 		[&](Tile* tile)
 		{
 			auto currLight = power;
@@ -278,7 +485,7 @@ void TileEngine::calculateSunShading(MapSubset gs)
 			}
 			tile->addLight(currLight, LL_AMBIENT);
 		}
-	);
+	); });
 }
 
 /**
@@ -287,6 +494,7 @@ void TileEngine::calculateSunShading(MapSubset gs)
 void TileEngine::calculateTerrainBackground(MapSubset gs)
 {
 	const int fireLightPower = 15; // amount of light a fire generates
+	std::vector<std::pair<Position, int>> lights;
 
 	// add lighting of fire
 	iterateTiles(
@@ -323,9 +531,14 @@ void TileEngine::calculateTerrainBackground(MapSubset gs)
 			{
 				currLight = getMaxStaticLightDistance() - 1;
 			}
-			addLight(gs, tile->getPosition(), currLight, LL_FIRE);
+			if (currLight > 0)
+			{
+				lights.push_back(std::make_pair(tile->getPosition(), currLight));
+			}
 		}
 	);
+
+	addLights(gs, lights, LL_FIRE);
 }
 
 /**
@@ -333,6 +546,8 @@ void TileEngine::calculateTerrainBackground(MapSubset gs)
   */
 void TileEngine::calculateTerrainItems(MapSubset gs)
 {
+	std::vector<std::pair<Position, int>> lights;
+
 	// add lighting of terrain
 	iterateTiles(
 		_save,
@@ -353,9 +568,14 @@ void TileEngine::calculateTerrainItems(MapSubset gs)
 			{
 				currLight = getMaxDynamicLightDistance() - 1;
 			}
-			addLight(gs, tile->getPosition(), currLight, LL_ITEMS);
+			if (currLight > 0)
+			{
+				lights.push_back(std::make_pair(tile->getPosition(), currLight));
+			}
 		}
 	);
+
+	addLights(gs, lights, LL_ITEMS);
 }
 
 /**
@@ -364,6 +584,7 @@ void TileEngine::calculateTerrainItems(MapSubset gs)
 void TileEngine::calculateUnitLighting(MapSubset gs)
 {
 	const int fireLightPower = 15; // amount of light a fire generates
+	std::vector<std::pair<Position, int>> lights;
 
 	for (BattleUnit *unit : *_save->getUnits())
 	{
@@ -396,16 +617,22 @@ void TileEngine::calculateUnitLighting(MapSubset gs)
 		{
 			currLight = getMaxDynamicLightDistance() - 1;
 		}
+		if (currLight <= 0)
+		{
+			continue;
+		}
 		const auto size = unit->getArmor()->getSize();
 		const auto pos = unit->getPosition();
 		for (int x = 0; x < size; ++x)
 		{
 			for (int y = 0; y < size; ++y)
 			{
-				addLight(gs, pos + Position(x, y, 0), currLight, LL_UNITS);
+				lights.push_back(std::make_pair(pos + Position(x, y, 0), currLight));
 			}
 		}
 	}
+
+	addLights(gs, lights, LL_UNITS);
 }
 
 void TileEngine::calculateLighting(LightLayers layer, Position position, int eventRadius, bool terrianChanged)
@@ -421,9 +648,12 @@ void TileEngine::calculateLighting(LightLayers layer, Position position, int eve
 
 	if (terrianChanged)
 	{
-		iterateTiles(
+		// walls, floors or doors changed, so old paths can't be trusted
+		_save->getReachabilityCache()->invalidate();
+
+		iterateBands(_save, mapArea(position, position != invalid ? eventRadius + 1 : 1000), [&](MapSubset band){ iterateTiles(
 			_save,
-			mapArea(position, position != invalid ? eventRadius + 1 : 1000),
+			band,
 			[&](Tile* tile)
 			{
 				const auto currPos = tile->getPosition();
@@ -476,29 +706,29 @@ void TileEngine::calculateLighting(LightLayers layer, Position position, int eve
 					}
 				}
 			}
-		);
+		); });
 	}
 
 	if (layer <= LL_FIRE)
 	{
-		iterateTiles(
+		iterateBands(_save, gsStatic, [&](MapSubset band){ iterateTiles(
 			_save,
-			gsStatic,
+			band,
 			[&](Tile* tile)
 			{
 				tile->resetLightMulti(layer);
 			}
-		);
+		); });
 	}
 
-	iterateTiles(
+	iterateBands(_save, gsDynamic, [&](MapSubset band){ iterateTiles(
 		_save,
-		gsDynamic,
+		band,
 		[&](Tile* tile)
 		{
 			tile->resetLightMulti(std::max(layer, LL_ITEMS));
 		}
-	);
+	); });
 
 	if (layer <= LL_AMBIENT) calculateSunShading(gsStatic);
 	if (layer <= LL_FIRE) calculateTerrainBackground(gsStatic);
@@ -506,6 +736,33 @@ void TileEngine::calculateLighting(LightLayers layer, Position position, int eve
 	if (layer <= LL_UNITS) calculateUnitLighting(gsDynamic);
 }
 
+/**
+ * Adds list of lights to subset of map, each band of map is processed by different thread.
+ * Every band applies lights in the same order, so result is same as adding them one by one.
+ * @param gs Subset of map to update.
+ * @param lights List of light positions and powers.
+ * @param layer Light layer.
+ */
+void TileEngine::addLights(MapSubset gs, const std::vector<std::pair<Position, int>> &lights, LightLayers layer)
+{
+	if (lights.empty())
+	{
+		return;
+	}
+
+	iterateBands(
+		_save,
+		gs,
+		[&](MapSubset band)
+		{
+			for (auto& l : lights)
+			{
+				addLight(band, l.first, l.second, layer);
+			}
+		}
+	);
+}
+
 /**
  * Adds circular light pattern starting from center and losing power with distance travelled.
  * @param center Center.
@@ -744,6 +1001,7 @@ inline bool TileEngine::inEventVisibilitySector(const Position &toCheck) const
 */
 bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos, const int eventRadius)
 {
+	BattleProfileScope profile(BPP_FOV);
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	bool useTurretDirection = false;
 	if (Options::strafe && (unit->getTurretType() > -1)) {
@@ -760,8 +1018,11 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 		unit->clearVisibleUnits();
 	}
 
+	//Units beyond max view distance can't be seen, only the ones seen before need to be checked to remove them.
+	_save->getUnitsInRange(posSelf, getMaxViewDistance(), _unitsInFOV, unit->getVisibleUnits());
+
 	//Loop through all units specified and figure out which ones we can actually see.
-	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	for (std::vector<BattleUnit*>::iterator i = _unitsInFOV.begin(); i != _unitsInFOV.end(); ++i)
 	{
 		Position posOther = (*i)->getPosition();
 		if (!(*i)->isOut() && (unit->getId() != (*i)->getId()))
@@ -834,6 +1095,7 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 */
 void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos, const int eventRadius)
 {
+	BattleProfileScope profile(BPP_FOV);
 	bool useTurretDirection = false;
 	bool skipNarrowArcTest = false;
 	int direction;
@@ -964,6 +1226,7 @@ void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos,
 */
 bool TileEngine::calculateFOV(BattleUnit *unit, bool doTileRecalc, bool doUnitRecalc)
 {
+	BattleProfileScope profile(BPP_FOV);
 	//Force a full FOV recheck for this unit.
 	if (doTileRecalc) calculateTilesInFOV(unit);
 	return doUnitRecalc ? calculateUnitsInFOV(unit) : false;
@@ -1339,7 +1602,6 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 {
 	Position targetVoxel = tile->getPosition().toVoxel() + Position(7, 8, 0);
 	Position scanVoxel;
-	std::vector<Position> _trajectory;
 	BattleUnit *otherUnit = tile->getUnit();
 	if (otherUnit == 0) return 0; //no unit in this tile, even if it elevated and appearing in it.
 	if (otherUnit == excludeUnit) return 0; //skip self
@@ -1376,6 +1638,7 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 
 	int targetMaxHeight=targetMinHeight+heightRange;
 	// scan ray from top to bottom  plus different parts of target cylinder
+	std::vector<Position> scanVoxels;
 	int total=0;
 	int visible=0;
 	for (int i = heightRange; i >=0; i-=2)
@@ -1386,18 +1649,24 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 		{
 			scanVoxel.x=targetVoxel.x + sliceTargets[j*2];
 			scanVoxel.y=targetVoxel.y + sliceTargets[j*2+1];
-			_trajectory.clear();
-			int test = calculateLineVoxel(*originVoxel, scanVoxel, false, &_trajectory, excludeUnit, excludeAllBut);
-			if (test == V_UNIT)
+			scanVoxels.push_back(scanVoxel);
+		}
+	}
+
+	std::vector<VoxelType> tests(scanVoxels.size());
+	std::vector<Position> impacts(scanVoxels.size());
+	calculateLineVoxelBatch(*originVoxel, scanVoxels.data(), (int)scanVoxels.size(), tests.data(), impacts.data(), excludeUnit, excludeAllBut);
+	for (size_t k = 0; k < scanVoxels.size(); ++k)
+	{
+		if (tests[k] == V_UNIT)
+		{
+			//voxel of hit must be inside of scanned box
+			if (impacts[k].x/16 == scanVoxels[k].x/16 &&
+				impacts[k].y/16 == scanVoxels[k].y/16 &&
+				impacts[k].z >= targetMinHeight &&
+				impacts[k].z <= targetMaxHeight)
 			{
-				//voxel of hit must be inside of scanned box
-				if (_trajectory.at(0).x/16 == scanVoxel.x/16 &&
-					_trajectory.at(0).y/16 == scanVoxel.y/16 &&
-					_trajectory.at(0).z >= targetMinHeight &&
-					_trajectory.at(0).z <= targetMaxHeight)
-				{
-					++visible;
-				}
+				++visible;
 			}
 		}
 	}
@@ -1691,21 +1960,25 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
  */
 void TileEngine::calculateFOV(Position position, int eventRadius, const bool updateTiles, const bool appendToTileVisibility)
 {
+	BattleProfileScope profile(BPP_FOV);
+	int updateRange;
 	int updateRadius;
 	if (eventRadius == -1)
 	{
 		eventRadius = getMaxViewDistance();
+		updateRange = getMaxViewDistance();
 		updateRadius = getMaxViewDistanceSq();
 	}
 	else
 	{
 		//Need to grab units which are out of range of the centre of the event, but can still see the edge of the effect.
-		updateRadius = getMaxViewDistance() + (eventRadius > 0 ? eventRadius : 0);
-		updateRadius *= updateRadius;
+		updateRange = getMaxViewDistance() + (eventRadius > 0 ? eventRadius : 0);
+		updateRadius = updateRange * updateRange;
 	}
-	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	_save->getUnitsInRange(position, updateRange, _unitsNearEvent);
+	for (std::vector<BattleUnit*>::iterator i = _unitsNearEvent.begin(); i != _unitsNearEvent.end(); ++i)
 	{
-		if (Position::distance2dSq(position, (*i)->getPosition()) <= updateRadius) //could this unit have observed the event?
+		if (Position::distance2dSq(position, (*i)->getPosition()) <= updateRadius && dependsOnEventArea((*i), position, eventRadius)) //could this unit have observed the event?
 		{
 			if (updateTiles)
 			{
@@ -1719,6 +1992,80 @@ void TileEngine::calculateFOV(Position position, int eventRadius, const bool upd
 			calculateUnitsInFOV((*i), position, eventRadius);
 		}
 	}
+
+	if (Options::verifyFOV)
+	{
+		verifyFOV(position, eventRadius);
+	}
+}
+
+/**
+ * Checks if an event can change what a unit sees.
+ * Everything a unit sees (and every obstacle that hides something from it) lies in its view sector,
+ * so an event area outside of the sector can't change its visible tiles or units.
+ * @param unit The observer.
+ * @param eventPos The centre of the event.
+ * @param eventRadius Radius of circle big enough to encompass the event.
+ * @return True if the FOV of the unit needs to be updated.
+ */
+bool TileEngine::dependsOnEventArea(BattleUnit *unit, Position eventPos, int eventRadius) const
+{
+	if (unit->isOut() || eventRadius <= 0 || eventRadius >= getMaxViewDistance())
+	{
+		return true;
+	}
+	// events touching the observer itself can affect any direction
+	const int touchRadius = eventRadius + unit->getArmor()->getSize();
+	if (Position::distance2dSq(eventPos, unit->getPosition()) <= touchRadius * touchRadius)
+	{
+		return true;
+	}
+	const bool useTurretDirection = Options::strafe && (unit->getTurretType() > -1);
+	// one extra tile to cover rounding of the event circle to tiles
+	const int r = eventRadius + 1;
+	for (int x = -r; x <= r; ++x)
+	{
+		for (int y = -r; y <= r; ++y)
+		{
+			if (x * x + y * y <= r * r && unit->checkViewSector(eventPos + Position(x, y, 0), useTurretDirection))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * Debug check of the incremental FOV update done by calculateFOV(Position, ...).
+ * Recalculates every unit from scratch and logs units whose result differs.
+ * The full result is kept afterwards.
+ * @param position Position of the event that was just processed.
+ * @param eventRadius Radius of the event.
+ */
+void TileEngine::verifyFOV(Position position, int eventRadius)
+{
+	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	{
+		if ((*i)->isOut() || (*i)->getTile() == 0)
+		{
+			continue;
+		}
+		std::vector<BattleUnit*> units = *(*i)->getVisibleUnits();
+		std::vector<Tile*> tiles = *(*i)->getVisibleTiles();
+		calculateFOV(*i);
+		std::vector<BattleUnit*> fullUnits = *(*i)->getVisibleUnits();
+		std::vector<Tile*> fullTiles = *(*i)->getVisibleTiles();
+		std::sort(units.begin(), units.end());
+		std::sort(fullUnits.begin(), fullUnits.end());
+		std::sort(tiles.begin(), tiles.end());
+		std::sort(fullTiles.begin(), fullTiles.end());
+		if (units != fullUnits || tiles != fullTiles)
+		{
+			Log(LOG_WARNING) << "FOV of unit " << (*i)->getId() << " at " << (*i)->getPosition() << " differs from full recalculation after event at " << position << " radius " << eventRadius
+				<< ": " << units.size() << "/" << fullUnits.size() << " units, " << tiles.size() << "/" << fullTiles.size() << " tiles";
+		}
+	}
 }
 
 /**
@@ -1729,6 +2076,7 @@ void TileEngine::calculateFOV(Position position, int eventRadius, const bool upd
  */
 bool TileEngine::checkReactionFire(BattleUnit *unit, const BattleAction &originalAction)
 {
+	BattleProfileScope profile(BPP_REACTION);
 	// reaction fire only triggered when the actioning unit is of the currently playing side, and is still on the map (alive)
 	if (unit->getFaction() != _save->getSide() || unit->getTile() == 0)
 	{
@@ -1785,7 +2133,8 @@ std::vector<TileEngine::ReactionScore> TileEngine::getSpottingUnits(BattleUnit*
 	// no reaction on civilian turn.
 	if (_save->getSide() != FACTION_NEUTRAL)
 	{
-		for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+		_save->getUnitsInRange(unit->getPosition(), getMaxViewDistance(), _unitsSpotting);
+		for (std::vector<BattleUnit*>::const_iterator i = _unitsSpotting.begin(); i != _unitsSpotting.end(); ++i)
 		{
 				// not dead/unconscious
 			if (!(*i)->isOut() &&
@@ -3481,6 +3830,10 @@ int TileEngine::closeUfoDoors()
 		}
 		doorsclosed += _save->getTile(i)->closeUfoDoor();
 	}
+	if (doorsclosed)
+	{
+		_save->getReachabilityCache()->invalidate();
+	}
 
 	return doorsclosed;
 }
@@ -3623,6 +3976,98 @@ VoxelType TileEngine::calculateLineVoxel(Position origin, Position target, bool
 	return V_EMPTY;
 }
 
+/**
+ * Calculates first hits of many lines starting from the same origin.
+ * Lines are stepped together one voxel at time, so nearly parallel rays check the same tiles one after another
+ * and reuse the tile cache of `voxelCheck`. Each result is the same as from `calculateLineVoxel` for that line.
+ * @param origin Origin in voxel.
+ * @param targets Targets in voxel.
+ * @param count Number of lines.
+ * @param results Returned objectnumber(0-3) or unit(4) or out of map (5) or -1(hit nothing) for each line.
+ * @param impacts Returned position of impact for each line, `invalid` if line hit nothing.
+ * @param excludeUnit Excludes this unit in the collision detection.
+ * @param excludeAllBut [Optional] The only unit to be considered for ray hits.
+ */
+void TileEngine::calculateLineVoxelBatch(Position origin, const Position *targets, int count, VoxelType *results, Position *impacts, BattleUnit *excludeUnit, BattleUnit *excludeAllBut)
+{
+	constexpr int lanes = 8;
+	bool excludeAllUnits = false;
+	if (_save->isBeforeGame())
+	{
+		excludeAllUnits = true; // see `calculateLineVoxel`
+	}
+
+	for (int first = 0; first < count; first += lanes)
+	{
+		const int size = std::min(lanes, count - first);
+		LineHitStepper lines[lanes];
+		int active = size;
+		for (int i = 0; i < size; ++i)
+		{
+			lines[i].init(origin, targets[first + i]);
+			results[first + i] = V_EMPTY;
+			impacts[first + i] = invalid;
+		}
+
+		while (active > 0)
+		{
+			for (int i = 0; i < size; ++i)
+			{
+				Position point;
+				if (!lines[i].next(point))
+				{
+					continue;
+				}
+				VoxelType result = voxelCheck(point, excludeUnit, excludeAllUnits, false, excludeAllBut);
+				if (result != V_EMPTY)
+				{
+					results[first + i] = result;
+					impacts[first + i] = point;
+					lines[i] = LineHitStepper();
+					--active;
+				}
+				else if (lines[i].isFinished())
+				{
+					--active;
+				}
+			}
+		}
+	}
+
+	if (Options::verifyLineBatch)
+	{
+		verifyLineBatch(origin, targets, count, results, impacts, excludeUnit, excludeAllBut);
+	}
+}
+
+/**
+ * Debug check of calculateLineVoxelBatch.
+ * Traces every line again with calculateLineVoxel and logs lines whose hit differs.
+ * @param origin Origin in voxel.
+ * @param targets Targets in voxel.
+ * @param count Number of lines.
+ * @param results Results of the batch.
+ * @param impacts Impacts of the batch.
+ * @param excludeUnit Excludes this unit in the collision detection.
+ * @param excludeAllBut [Optional] The only unit to be considered for ray hits.
+ */
+void TileEngine::verifyLineBatch(Position origin, const Position *targets, int count, const VoxelType *results, const Position *impacts, BattleUnit *excludeUnit, BattleUnit *excludeAllBut)
+{
+	std::vector<Position> trajectory;
+	for (int i = 0; i < count; ++i)
+	{
+		trajectory.clear();
+		VoxelType result = calculateLineVoxel(origin, targets[i], false, &trajectory, excludeUnit, excludeAllBut);
+		Position impact = trajectory.empty() ? invalid : trajectory.front();
+		if (result != results[i] || impact != impacts[i])
+		{
+			++_lineBatchMismatches;
+			Log(LOG_WARNING) << "Line from " << origin << " to " << targets[i] << " hits " << (int)results[i] << " at " << impacts[i]
+				<< " in a batch but " << (int)result << " at " << impact << " alone";
+		}
+	}
+}
+
 /**
  * Calculates a parabola trajectory, used for throwing items.
  * @param origin Origin in voxelspace.
@@ -3780,6 +4225,7 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 		_cacheTilePos = pos;
 		_cacheTile = tile;
 		_cacheTileBelow = tileBelow;
+		_cacheTileIndex = _save->getTileIndex(pos);
  	}
 
 	if (tile->isVoid() && tile->getUnit() == 0 && (!tileBelow || tileBelow->getUnit() == 0))
@@ -3796,20 +4242,29 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 	}
 
 	// first we check terrain voxel data, not to allow 2x2 units stick through walls
-	for (int i = V_FLOOR; i <= V_OBJECT; ++i)
+	if (tile->isVoxelDirty())
 	{
-		TilePart tp = (TilePart)i;
-		MapData *mp = tile->getMapData(tp);
-		if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
-			continue;
-		if (mp != 0)
+		updateVoxelBlock(tile, _cacheTileIndex);
+	}
+	const VoxelBlock &block = _voxelBlocks[_voxelBlockIndex[_cacheTileIndex]];
+	if (block.rows[(voxel.z%24)/2][voxel.y%16] & (1 << (15 - voxel.x%16)))
+	{
+		// hit, find which part it belongs to
+		for (int i = V_FLOOR; i <= V_OBJECT; ++i)
 		{
-			int x = 15 - voxel.x%16;
-			int y = voxel.y%16;
-			int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
-			if (_voxelData->at(idx) & (1 << x))
+			TilePart tp = (TilePart)i;
+			MapData *mp = tile->getMapData(tp);
+			if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
+				continue;
+			if (mp != 0)
 			{
-				return (VoxelType)i;
+				int x = 15 - voxel.x%16;
+				int y = voxel.y%16;
+				int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
+				if (_voxelData->at(idx) & (1 << x))
+				{
+					return (VoxelType)i;
+				}
 			}
 		}
 	}
@@ -4810,6 +5265,7 @@ bool TileEngine::validateThrow(BattleAction &action, Position originVoxel, Posit
  */
 void TileEngine::recalculateFOV()
 {
+	BattleProfileScope profile(BPP_FOV);
 	for (std::vector<BattleUnit*>::iterator bu = _save->getUnits()->begin(); bu != _save->getUnits()->end(); ++bu)
 	{
 		if ((*bu)->getTile() != 0)
@@ -18,6 +18,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <vector>
+#include <array>
+#include <map>
 #include "Position.h"
 #include "BattlescapeGame.h"
 #include "../Mod/RuleItem.h"
@@ -95,11 +97,27 @@ private:
 	std::vector<Uint16> *_voxelData;
 	std::vector<VisibilityBlockCache> _blockVisibility;
 	RuleInventory *_inventorySlotGround;
+	/// Reused results of SavedBattleGame::getUnitsInRange, separate for each function as FOV calls are nested.
+	std::vector<BattleUnit*> _unitsInFOV, _unitsNearEvent, _unitsSpotting;
 	constexpr static int heightFromCenter[11] = {0,-2,+2,-4,+4,-6,+6,-8,+8,-12,+12};
 	bool _personalLighting;
 	Tile *_cacheTile;
 	Tile *_cacheTileBelow;
 	Position _cacheTilePos;
+	int _cacheTileIndex;
+
+	/**
+	 * Combined voxel shape of static terrain parts of one tile, one 16x16 bit slice per LOFT layer.
+	 */
+	struct VoxelBlock
+	{
+		Uint16 rows[12][16];
+	};
+	/// Key of voxel block, effective terrain parts of tile (open ufo doors are skipped).
+	using VoxelBlockKey = std::array<const MapData*, 4>;
+	std::vector<VoxelBlock> _voxelBlocks;
+	std::vector<Uint32> _voxelBlockIndex;
+	std::map<VoxelBlockKey, Uint32> _voxelBlockLookup;
 	const int _maxViewDistance;        // 20 tiles by default
 	const int _maxViewDistanceSq;      // 20 * 20
 	const int _maxVoxelViewDistance;   // maxViewDistance * 16
@@ -111,8 +129,12 @@ private:
 	std::vector<BattleUnit*> _movingUnitPrev;
 	BattleUnit* _movingUnit = nullptr;
 
+	/// Rebuilds voxel block of tile after its terrain changed.
+	void updateVoxelBlock(Tile *tile, int index);
 	/// Add light source.
 	void addLight(MapSubset gs, Position center, int power, LightLayers layer);
+	/// Add list of light sources.
+	void addLights(MapSubset gs, const std::vector<std::pair<Position, int>> &lights, LightLayers layer);
 	/// Calculate blockage amount.
 	int blockage(Tile *tile, const TilePart part, ItemDamageType type, int direction = -1, bool checkingFromOrigin = false);
 	/// Get max distance that fire light can reach.
@@ -121,8 +143,6 @@ private:
 	int getMaxDynamicLightDistance() const { return _maxDynamicLightDistance; }
 	/// Get flags for enhanced lighting.
 	int getEnhancedLighting() const { return _enhancedLighting; }
-	/// Get max view distance.
-	int getMaxViewDistance() const { return _maxViewDistance; }
 	/// Get square of max view distance.
 	int getMaxViewDistanceSq() const { return _maxViewDistanceSq; }
 	/// Get max view distance in voxel space.
@@ -132,6 +152,14 @@ private:
 
 	bool setupEventVisibilitySector(const Position &observerPos, const Position &eventPos, const int &eventRadius);
 	inline bool inEventVisibilitySector(const Position &toCheck) const;
+	/// Checks if an event can change what a unit sees.
+	bool dependsOnEventArea(BattleUnit *unit, Position eventPos, int eventRadius) const;
+	/// Compares an incremental FOV update with a full recalculation.
+	void verifyFOV(Position position, int eventRadius);
+	/// Lines whose batched hit differed from the single line one.
+	static int _lineBatchMismatches;
+	/// Compares the hits of a line batch with tracing each line alone.
+	void verifyLineBatch(Position origin, const Position *targets, int count, const VoxelType *results, const Position *impacts, BattleUnit *excludeUnit, BattleUnit *excludeAllBut);
 
 	/// Calculates sun shading of the whole map.
 	void calculateSunShading(MapSubset gs);
@@ -155,6 +183,8 @@ public:
 	TileEngine(SavedBattleGame *save, Mod *mod);
 	/// Cleans up the TileEngine.
 	~TileEngine();
+	/// Get max view distance.
+	int getMaxViewDistance() const { return _maxViewDistance; }
 	/// Calculates visible tiles within the field of view. Supply an eventPosition to do an update limited to a small slice of the view sector.
 	void calculateTilesInFOV(BattleUnit *unit, const Position eventPos = invalid, const int eventRadius = 0);
 	/// Calculates visible units within the field of view. Supply an eventPosition to do an update limited to a small slice of the view sector.
@@ -187,6 +217,10 @@ public:
 	int calculateLineTile(Position origin, Position target, std::vector<Position> &trajectory);
 	/// Calculates a line trajectory in voxel space.
 	VoxelType calculateLineVoxel(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, BattleUnit *excludeAllBut = 0, bool onlyVisible = false);
+	/// Calculates first hits of many lines starting from the same origin.
+	void calculateLineVoxelBatch(Position origin, const Position *targets, int count, VoxelType *results, Position *impacts, BattleUnit *excludeUnit, BattleUnit *excludeAllBut = 0);
+	/// Gets the number of line batch hits that differed from single lines, see verifyLineBatch.
+	static int getLineBatchMismatches() { return _lineBatchMismatches; }
 	/// Calculates a parabola trajectory.
 	int calculateParabolaVoxel(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, double curvature, const Position delta);
 	/// Gets the origin voxel of a unit's eyesight.
@@ -0,0 +1,325 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AsyncLoader.h"
+#include <memory>
+#include "FileMap.h"
+#include "CrossPlatform.h"
+#include "SDL2Helpers.h"
+#include "Logger.h"
+#include "../lodepng.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Limit of decoded images waiting to be taken, oldest ones are dropped first.
+const size_t MaxReadyBytes = 16 * 1024 * 1024;
+
+/// Loader shared by whole game, created only when something is prefetched.
+std::unique_ptr<AsyncLoader> SharedLoader;
+
+}
+
+/**
+ * Creates loader with one worker thread.
+ */
+AsyncLoader::AsyncLoader() : _readyBytes(0), _nextOrder(0), _loading(0), _prefetched(0), _used(0), _late(0), _unused(0), _savedTime(0), _worker(1)
+{
+
+}
+
+/**
+ * Drops queued files and waits for worker.
+ */
+AsyncLoader::~AsyncLoader()
+{
+	clear();
+}
+
+/**
+ * Queues file for background loading.
+ * PNG images are decoded and wait for the surface that will use them,
+ * other files are only read to have them ready in memory.
+ * Needs to be called from render thread.
+ * @param filename Name of file in VFS.
+ */
+void AsyncLoader::prefetch(const std::string &filename)
+{
+	if (!FileMap::fileExists(filename))
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_entries.emplace(filename, Entry{}).second)
+		{
+			return;
+		}
+		++_prefetched;
+	}
+	_worker.push([this, filename]{ work(filename); });
+}
+
+/**
+ * Loads one queued file, skips it if it was already taken or dropped.
+ * @param filename Name of file in VFS.
+ */
+void AsyncLoader::work(const std::string &filename)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto i = _entries.find(filename);
+		if (i == _entries.end() || i->second.state != ENTRY_QUEUED)
+		{
+			return;
+		}
+		i->second.state = ENTRY_LOADING;
+		++_loading;
+	}
+
+	const bool png = CrossPlatform::compareExt(filename, "png");
+	StagedImage image;
+	bool ready = false;
+	Uint32 start = SDL_GetTicks();
+	SDL_RWops *rw = FileMap::at(filename)->getRWopsReadAll();
+	if (rw)
+	{
+		if (png)
+		{
+			size_t size = 0;
+			void *data = SDL_LoadFile_RW(rw, &size, SDL_FALSE);
+			if (data)
+			{
+				std::string error;
+				ready = decodePng(data, size, image, error);
+				SDL_free(data);
+			}
+		}
+		SDL_RWclose(rw);
+	}
+	image.decodeTime = SDL_GetTicks() - start;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		--_loading;
+		auto i = _entries.find(filename);
+		if (i != _entries.end())
+		{
+			if (!png)
+			{
+				// nobody waits for raw files, they only needed to be read once
+				_entries.erase(i);
+			}
+			else if (ready)
+			{
+				i->second.state = ENTRY_READY;
+				i->second.order = ++_nextOrder;
+				i->second.image = std::move(image);
+				_readyBytes += i->second.image.pixels.size();
+				_readyOrder.emplace_back(i->second.order, filename);
+				trim();
+			}
+			else
+			{
+				i->second.state = ENTRY_FAILED;
+			}
+		}
+	}
+	_done.notify_all();
+}
+
+/**
+ * Takes decoded image if it was prefetched.
+ * If image is still decoding, waits for it; if worker did not start on it yet,
+ * entry is dropped and caller should load the file itself.
+ * @param filename Name of file in VFS.
+ * @param image Gets decoded image.
+ * @return True if image was decoded in background.
+ */
+bool AsyncLoader::take(const std::string &filename, StagedImage &image)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto i = _entries.find(filename);
+	if (i == _entries.end())
+	{
+		return false;
+	}
+	if (i->second.state == ENTRY_LOADING)
+	{
+		_done.wait(lock, [&]{ i = _entries.find(filename); return i == _entries.end() || i->second.state != ENTRY_LOADING; });
+		if (i == _entries.end())
+		{
+			return false;
+		}
+	}
+
+	bool ready = false;
+	if (i->second.state == ENTRY_READY)
+	{
+		_readyBytes -= i->second.image.pixels.size();
+		image = std::move(i->second.image);
+		_savedTime += image.decodeTime;
+		++_used;
+		ready = true;
+	}
+	else if (i->second.state == ENTRY_QUEUED)
+	{
+		++_late;
+	}
+	_entries.erase(i);
+	return ready;
+}
+
+/**
+ * Drops oldest decoded images until cache fits its limit,
+ * also forgets order of images that were already taken.
+ * Need to be called with locked mutex.
+ */
+void AsyncLoader::trim()
+{
+	while (!_readyOrder.empty())
+	{
+		auto i = _entries.find(_readyOrder.front().second);
+		const bool stale = i == _entries.end() || i->second.state != ENTRY_READY || i->second.order != _readyOrder.front().first;
+		if (!stale && _readyBytes <= MaxReadyBytes)
+		{
+			break;
+		}
+		if (!stale)
+		{
+			_readyBytes -= i->second.image.pixels.size();
+			++_unused;
+			_entries.erase(i);
+		}
+		_readyOrder.pop_front();
+	}
+}
+
+/**
+ * Drops all results, files that are in progress are discarded when worker finishes them.
+ * Called when game changes scene and nobody will take old images.
+ */
+void AsyncLoader::evict()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (auto &e : _entries)
+	{
+		if (e.second.state == ENTRY_READY)
+		{
+			++_unused;
+		}
+	}
+	_entries.clear();
+	_readyOrder.clear();
+	_readyBytes = 0;
+}
+
+/**
+ * Drops all results and waits for files that are in progress.
+ * Need to be called before VFS is changed.
+ */
+void AsyncLoader::clear()
+{
+	evict();
+	std::unique_lock<std::mutex> lock(_mutex);
+	_done.wait(lock, [&]{ return _loading == 0; });
+}
+
+/**
+ * Logs how much work was moved out of render thread.
+ */
+void AsyncLoader::report()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_prefetched == 0)
+	{
+		return;
+	}
+	Log(LOG_INFO) << "Async loader: " << _prefetched << " files prefetched, " << _used << " images used, " << _late << " too late, " << _unused << " unused, " << _savedTime << "ms of decoding done in background";
+	_prefetched = 0;
+	_used = 0;
+	_late = 0;
+	_unused = 0;
+	_savedTime = 0;
+}
+
+/**
+ * Decodes 8bit PNG image from memory.
+ * Safe to call from any thread.
+ * @param data PNG file content.
+ * @param size Size of data.
+ * @param image Gets decoded pixels and palette.
+ * @param error Gets reason of failure, stays empty if data is not 8bit PNG at all.
+ * @return True if image was decoded.
+ */
+bool AsyncLoader::decodePng(const void *data, size_t size, StagedImage &image, std::string &error)
+{
+	if (size <= 8 + 12 + 12) // minimal PNG file size: header and two empty chunks
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> pixels;
+	unsigned width, height;
+	lodepng::State state;
+	state.decoder.color_convert = 0;
+	unsigned err = lodepng::decode(pixels, width, height, state, (const unsigned char*)data, size);
+	if (err)
+	{
+		error = lodepng_error_text(err);
+		return false;
+	}
+	LodePNGColorMode *color = &state.info_png.color;
+	if (lodepng_get_bpp(color) != 8)
+	{
+		return false; // not an error, other loaders can handle it
+	}
+
+	image.width = width;
+	image.height = height;
+	image.pixels = std::move(pixels);
+	image.palette.assign((SDL_Color*)color->palette, (SDL_Color*)color->palette + color->palettesize);
+	return true;
+}
+
+/**
+ * Gets loader shared by whole game, its worker thread is started on first use.
+ * Needs to be called from render thread.
+ */
+AsyncLoader &AsyncLoader::getShared()
+{
+	if (!SharedLoader)
+	{
+		SharedLoader.reset(new AsyncLoader());
+	}
+	return *SharedLoader;
+}
+
+/**
+ * Gets loader shared by whole game if it was already created.
+ * @return Loader or null if nothing was prefetched yet.
+ */
+AsyncLoader *AsyncLoader::findShared()
+{
+	return SharedLoader.get();
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include "WorkerPool.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Image decoded outside of render thread, waiting to be copied to surface.
+ */
+struct StagedImage
+{
+	int width = 0;
+	int height = 0;
+	std::vector<Uint8> pixels;
+	std::vector<SDL_Color> palette;
+	Uint32 decodeTime = 0;
+};
+
+/**
+ * Background loader of game resources.
+ * Reads and decodes files on its own thread, render thread only takes finished results.
+ */
+class AsyncLoader
+{
+private:
+	enum EntryState { ENTRY_QUEUED, ENTRY_LOADING, ENTRY_READY, ENTRY_FAILED };
+	struct Entry
+	{
+		EntryState state = ENTRY_QUEUED;
+		int order = 0;
+		StagedImage image;
+	};
+
+	std::unordered_map<std::string, Entry> _entries;
+	std::deque<std::pair<int, std::string>> _readyOrder;
+	size_t _readyBytes;
+	int _nextOrder;
+	std::mutex _mutex;
+	std::condition_variable _done;
+	int _loading;
+	int _prefetched, _used, _late, _unused;
+	Uint32 _savedTime;
+	WorkerPool _worker;
+
+	/// Loads one queued file on worker thread.
+	void work(const std::string &filename);
+	/// Drops oldest decoded images when cache is over its limit.
+	void trim();
+public:
+	/// Creates loader with one worker thread.
+	AsyncLoader();
+	/// Stops loader.
+	~AsyncLoader();
+	/// Queues file for background loading.
+	void prefetch(const std::string &filename);
+	/// Takes decoded image if it was prefetched.
+	bool take(const std::string &filename, StagedImage &image);
+	/// Drops all results without waiting for files in progress.
+	void evict();
+	/// Drops all results and waits for files that are in progress.
+	void clear();
+	/// Logs how much work was moved out of render thread.
+	void report();
+	/// Decodes 8bit PNG image from memory.
+	static bool decodePng(const void *data, size_t size, StagedImage &image, std::string &error);
+	/// Gets loader shared by whole game, creates it on first use.
+	static AsyncLoader &getShared();
+	/// Gets loader shared by whole game if it was already created.
+	static AsyncLoader *findShared();
+};
+
+}
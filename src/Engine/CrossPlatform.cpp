@@ -76,6 +76,8 @@
 #include <cxxabi.h>
 #include <dlfcn.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include "Unicode.h"
 #endif		/* #ifdef _WIN32 */
 #include <SDL.h>
@@ -879,6 +881,34 @@ time_t getDateModified(const std::string &path)
 #endif
 }
 
+/**
+ * Gets the size of a file.
+ * @param path Full path to file.
+ * @return Size in bytes, 0 if the file is missing.
+ */
+Uint64 getFileSize(const std::string &path)
+{
+#ifdef _WIN32
+	auto pathW = pathToWindows(path);
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExW(pathW.c_str(), GetFileExInfoStandard, &data))
+	{
+		return 0;
+	}
+	return ((Uint64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) == 0)
+	{
+		return info.st_size;
+	}
+	else
+	{
+		return 0;
+	}
+#endif
+}
+
 /**
  * Converts a date/time into a human-readable string
  * using the ISO 8601 standard.
@@ -924,9 +954,12 @@ bool moveFile(const std::string &src, const std::string &dest)
 	auto dstW = pathToWindows(dest);
 	return (MoveFileExW(srcW.c_str(), dstW.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
 #else
-	// TODO In fact all remaining uses of this are renaming files inside a single directory
-	// so we may as well uncomment the rename() and drop the rest.
-	//return (rename(src.c_str(), dest.c_str()) == 0);
+	// all remaining uses of this are renaming files inside a single directory,
+	// copying is only a fallback for the rare case rename() can't do it
+	if (rename(src.c_str(), dest.c_str()) == 0)
+	{
+		return true;
+	}
 	std::ifstream srcStream;
 	std::ofstream destStream;
 	srcStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
@@ -1032,6 +1065,84 @@ std::unique_ptr<std::istream> readFile(const std::string& filename) {
 	return std::unique_ptr<std::istream>(new std::istringstream(datastr));
 }
 
+/**
+ * Maps whole file to memory for reading, without copying it.
+ * @param filename File to map.
+ * @param size Size of mapped data.
+ * @return Pointer to file data, or NULL if file can't be mapped (e.g. empty file).
+ */
+const void *mapFile(const std::string& filename, size_t &size)
+{
+	size = 0;
+#ifdef _WIN32
+	auto pathW = pathToWindows(filename);
+	HANDLE fh = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fh == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fh, &fileSize) || fileSize.QuadPart == 0 || (Uint64)fileSize.QuadPart > (Uint64)SIZE_MAX)
+	{
+		CloseHandle(fh);
+		return NULL;
+	}
+	HANDLE mh = CreateFileMappingW(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(fh);
+	if (mh == NULL)
+	{
+		return NULL;
+	}
+	// view keep mapping alive after handles are closed
+	const void *data = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mh);
+	if (data == NULL)
+	{
+		return NULL;
+	}
+	size = (size_t)fileSize.QuadPart;
+	return data;
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return NULL;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0)
+	{
+		close(fd);
+		return NULL;
+	}
+	void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		return NULL;
+	}
+	size = (size_t)info.st_size;
+	return data;
+#endif
+}
+
+/**
+ * Releases memory mapped by mapFile.
+ * @param data Pointer returned by mapFile.
+ * @param size Size returned by mapFile.
+ */
+void unmapFile(const void *data, size_t size)
+{
+	if (data == NULL)
+	{
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+#else
+	munmap(const_cast<void *>(data), size);
+#endif
+}
+
 /**
  * Gets an istream to a file's bytes at least up to and including first "\n---" sequence.
  * To be used only for savegames.
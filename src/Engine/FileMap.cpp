@@ -36,9 +36,14 @@
  * A. somename.zip is always scanned before somename/ directory.
  */
 
+#include <climits>
 #include <string>
 #include <sstream>
 #include <istream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -48,6 +53,7 @@
 #include "CrossPlatform.h"
 #include "Options.h"
 #include "Exception.h"
+#include "AsyncLoader.h"
 
 #define MINIZ_NO_STDIO
 #include "../../libs/miniz/miniz.h"
@@ -205,12 +211,250 @@ static inline std::string concatOptionalPaths(const std::string& basePath, const
 	}
 }
 
+/**
+ * Read-only view of file data, keeps memory behind it alive.
+ */
+struct FileView
+{
+	std::shared_ptr<const void> owner;
+	const char *data = nullptr;
+	size_t size = 0;
+};
+
+/// Max total size of decompressed zip entries kept in cache.
+static const size_t InflateCacheLimit = 64 * 1024 * 1024;
+
+/**
+ * Cache of decompressed zip entries, least recently used entries are dropped first.
+ * Entries still used by some view stay alive until view is released.
+ */
+class InflateCache
+{
+	typedef std::pair<const mz_zip_archive *, mz_uint> Key;
+	typedef std::pair<Key, std::shared_ptr<std::vector<char>>> Entry;
+	std::list<Entry> _entries;
+	std::map<Key, std::list<Entry>::iterator> _index;
+	size_t _size = 0;
+
+public:
+	/// Gets decompressed zip entry, from cache or by extracting it.
+	std::shared_ptr<std::vector<char>> get(mz_zip_archive *zip, mz_uint findex)
+	{
+		Key key = std::make_pair(zip, findex);
+		auto i = _index.find(key);
+		if (i != _index.end())
+		{
+			_entries.splice(_entries.begin(), _entries, i->second);
+			return i->second->second;
+		}
+
+		size_t size;
+		void *raw = mz_zip_reader_extract_to_heap(zip, findex, &size, 0);
+		if (raw == NULL)
+		{
+			return nullptr;
+		}
+		auto data = std::make_shared<std::vector<char>>((char *)raw, (char *)raw + size);
+		mz_free(raw);
+		if (size > InflateCacheLimit / 4)
+		{
+			return data;
+		}
+
+		_entries.push_front(std::make_pair(key, data));
+		_index[key] = _entries.begin();
+		_size += size;
+		while (_size > InflateCacheLimit)
+		{
+			auto& last = _entries.back();
+			_size -= last.second->size();
+			_index.erase(last.first);
+			_entries.pop_back();
+		}
+		return data;
+	}
+
+	/// Drops all entries.
+	void clear()
+	{
+		_entries.clear();
+		_index.clear();
+		_size = 0;
+	}
+};
+
+static std::mutex ZipMutex;                   // guards zip extraction, miniz contexts can't be used by two threads at once
+static InflateCache ZipInflateCache;
+static std::unordered_map<const mz_zip_archive *, std::shared_ptr<const void>> ZipMappings; // zip files mapped in memory
+static std::mutex ViewOwnersMutex;
+static std::unordered_map<SDL_RWops *, std::shared_ptr<const void>> ViewOwners; // memory used by open view RWops
+
+/**
+ * Maps whole file to memory.
+ * @param path File to map.
+ * @param view Result view.
+ * @return True if file was mapped.
+ */
+static bool mapFileView(const std::string &path, FileView &view)
+{
+	size_t size;
+	const void *data = CrossPlatform::mapFile(path, size);
+	if (data == NULL)
+	{
+		return false;
+	}
+	view.owner = std::shared_ptr<const void>(data, [size](const void *d){ CrossPlatform::unmapFile(d, size); });
+	view.data = (const char *)data;
+	view.size = size;
+	return true;
+}
+
+/**
+ * Gets view of file data without copying it when possible.
+ * Loose files and stored zip entries are served from mapped memory,
+ * compressed zip entries are decompressed once to shared cache.
+ * @param rec File record.
+ * @param view Result view.
+ * @return True if view is available, otherwise caller need to read file other way.
+ */
+static bool getFileView(const FileRecord &rec, FileView &view)
+{
+	if (rec.zip == NULL)
+	{
+		return mapFileView(rec.fullpath, view);
+	}
+
+	std::lock_guard<std::mutex> lock(ZipMutex);
+	mz_zip_archive *zip = (mz_zip_archive *)rec.zip;
+	mz_zip_archive_file_stat fistat;
+	if (!mz_zip_reader_file_stat(zip, (mz_uint)rec.findex, &fistat) || fistat.m_uncomp_size == 0)
+	{
+		return false;
+	}
+
+	auto mapping = ZipMappings.find(zip);
+	if (fistat.m_method == 0 && mapping != ZipMappings.end())
+	{
+		// stored entry, data follow local header directly
+		const Uint8 *base = (const Uint8 *)mapping->second.get();
+		const mz_uint64 zipSize = zip->m_archive_size;
+		const mz_uint64 header = fistat.m_local_header_ofs;
+		if (header + 30 <= zipSize && base[header] == 'P' && base[header + 1] == 'K' && base[header + 2] == 3 && base[header + 3] == 4)
+		{
+			const mz_uint64 nameLen = base[header + 26] | (base[header + 27] << 8);
+			const mz_uint64 extraLen = base[header + 28] | (base[header + 29] << 8);
+			const mz_uint64 offset = header + 30 + nameLen + extraLen;
+			if (offset + fistat.m_comp_size <= zipSize && fistat.m_comp_size == fistat.m_uncomp_size)
+			{
+				view.owner = mapping->second;
+				view.data = (const char *)base + offset;
+				view.size = (size_t)fistat.m_comp_size;
+				return true;
+			}
+		}
+	}
+
+	auto data = ZipInflateCache.get(zip, (mz_uint)rec.findex);
+	if (!data)
+	{
+		return false;
+	}
+	view.data = data->data();
+	view.size = data->size();
+	view.owner = std::move(data);
+	return true;
+}
+
+/**
+ * Close callback of RWops created from view.
+ */
+static int viewops_close(SDL_RWops *context)
+{
+	if (context)
+	{
+		{
+			std::lock_guard<std::mutex> lock(ViewOwnersMutex);
+			ViewOwners.erase(context);
+		}
+		SDL_FreeRW(context);
+	}
+	return 0;
+}
+
+/**
+ * Wraps view in RWops, memory of view is released when RWops is closed.
+ * SDL RWops size is an int, bigger views have to be read from the file.
+ */
+static SDL_RWops *rwopsFromView(const FileView &view)
+{
+	SDL_RWops *rv = SDL_RWFromConstMem(view.data, (int)view.size);
+	if (rv)
+	{
+		{
+			std::lock_guard<std::mutex> lock(ViewOwnersMutex);
+			ViewOwners[rv] = view.owner;
+		}
+		rv->close = viewops_close;
+	}
+	return rv;
+}
+
+/**
+ * Stream buffer reading directly from view.
+ */
+class ViewStreamBuf : public std::streambuf
+{
+	std::shared_ptr<const void> _owner;
+
+protected:
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+	{
+		char *pos = (dir == std::ios_base::beg) ? eback() : (dir == std::ios_base::end) ? egptr() : gptr();
+		pos += off;
+		if (!(which & std::ios_base::in) || pos < eback() || pos > egptr())
+		{
+			return pos_type(off_type(-1));
+		}
+		setg(eback(), pos, egptr());
+		return pos_type(pos - eback());
+	}
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+	{
+		return seekoff(off_type(pos), std::ios_base::beg, which);
+	}
+
+public:
+	ViewStreamBuf(const FileView &view) : _owner(view.owner)
+	{
+		char *begin = const_cast<char *>(view.data);
+		setg(begin, begin, begin + view.size);
+	}
+};
+
+/**
+ * Input stream reading directly from view.
+ */
+class ViewStream : public std::istream
+{
+	ViewStreamBuf _buf;
+
+public:
+	ViewStream(const FileView &view) : std::istream(nullptr), _buf(view)
+	{
+		rdbuf(&_buf);
+	}
+};
+
 FileRecord::FileRecord() : fullpath(""), zip(NULL), findex(0) { }
 
 SDL_RWops *FileRecord::getRWops() const
 {
 	SDL_RWops *rv;
-	if (zip != NULL) {
+	FileView view;
+	if (getFileView(*this, view) && view.size <= INT_MAX) {
+		rv = rwopsFromView(view);
+	} else if (zip != NULL) {
+		std::lock_guard<std::mutex> lock(ZipMutex);
 		rv = SDL_RWFromMZ((mz_zip_archive *)zip, findex);
 	} else {
 		rv = SDL_RWFromFile(fullpath.c_str(), "rb");
@@ -222,8 +466,14 @@ SDL_RWops *FileRecord::getRWops() const
 SDL_RWops *FileRecord::getRWopsReadAll() const
 {
 	SDL_RWops *rv;
-	if (zip != NULL)
+	FileView view;
+	if (getFileView(*this, view) && view.size <= INT_MAX)
+	{
+		rv = rwopsFromView(view);
+	}
+	else if (zip != NULL)
 	{
+		std::lock_guard<std::mutex> lock(ZipMutex);
 		rv = SDL_RWFromMZ((mz_zip_archive *)zip, findex);
 	}
 	else
@@ -264,7 +514,12 @@ SDL_RWops *FileRecord::getRWopsReadAll() const
 
 std::unique_ptr<std::istream> FileRecord::getIStream() const
 {
+	FileView view;
+	if (getFileView(*this, view)) {
+		return std::unique_ptr<std::istream>(new ViewStream(view));
+	}
 	if (zip != NULL) {
+		std::lock_guard<std::mutex> lock(ZipMutex);
 		size_t size;
 		void *data = mz_zip_reader_extract_to_heap((mz_zip_archive *)zip, findex, &size, 0);
 		if (data == NULL) {
@@ -282,6 +537,33 @@ std::unique_ptr<std::istream> FileRecord::getIStream() const
 	}
 }
 
+/**
+ * Gets value that change when file content change.
+ * For zipped files it's based on checksum and size of entry,
+ * for plain files on modification time and size.
+ * @return Stamp of file.
+ */
+Uint64 FileRecord::getStamp() const
+{
+	if (zip != NULL)
+	{
+		mz_zip_archive_file_stat fistat;
+		if (!mz_zip_reader_file_stat((mz_zip_archive *)zip, findex, &fistat))
+		{
+			return 0;
+		}
+		return ((Uint64)fistat.m_crc32 << 32) ^ (Uint64)fistat.m_uncomp_size;
+	}
+	Uint64 size = 0;
+	SDL_RWops *rw = SDL_RWFromFile(fullpath.c_str(), "rb");
+	if (rw)
+	{
+		size = (Uint64)SDL_RWsize(rw);
+		SDL_RWclose(rw);
+	}
+	return ((Uint64)CrossPlatform::getDateModified(fullpath) << 24) ^ size;
+}
+
 YAML::Node FileRecord::getYAML() const
 {
 	try
@@ -356,7 +638,7 @@ static bool isRuleset(const std::string& fname) {
 
 typedef std::unordered_map<std::string, FileRecord> FileSet;
 static const NameSet emptySet;
-static mz_zip_archive *newZipContext(const std::string& log_ctx, SDL_RWops *rwops);
+static mz_zip_archive *newZipContext(const std::string& log_ctx, SDL_RWops *rwops, std::shared_ptr<const void> mapping = nullptr);
 
 struct VFSLayer {
 	std::string fullpath;				// the origin
@@ -691,7 +973,7 @@ static VFS TheVFS;
 
 const RSOrder &getRulesets() { return TheVFS.get_rulesets(); }
 
-static mz_zip_archive *newZipContext(const std::string& log_ctx, SDL_RWops *rwops) {
+static mz_zip_archive *newZipContext(const std::string& log_ctx, SDL_RWops *rwops, std::shared_ptr<const void> mapping) {
 	mz_zip_archive *zip = (mz_zip_archive *) SDL_malloc(sizeof(mz_zip_archive));
 	if (!zip) {
 		Log(LOG_FATAL) << log_ctx << ": " << SDL_GetError();
@@ -705,17 +987,26 @@ static mz_zip_archive *newZipContext(const std::string& log_ctx, SDL_RWops *rwop
 		return NULL;
 	}
 	ZipContexts.push_back(zip);
+	if (mapping) {
+		ZipMappings[zip] = std::move(mapping);
+	}
 	return zip;
 }
 
 void clear(bool clearOnly, bool embeddedOnly) {
+	if (AsyncLoader *loader = AsyncLoader::findShared())
+	{
+		loader->clear(); // background loads must not see VFS change
+	}
 	TheVFS.clear();
 	for(auto i : ModsAvailable ) { delete i.second; }
 	ModsAvailable.clear();
 	for (auto i : MappedVFSLayers ) { delete i; }
 	MappedVFSLayers.clear();
+	ZipInflateCache.clear();
 	for (auto i : ZipContexts) { mz_zip_reader_end_rwops(i); SDL_free(i); }
 	ZipContexts.clear();
+	ZipMappings.clear();
 	if (!clearOnly)
 	{
 		Log(LOG_VERBOSE) << "FileMap::clear(): mapping 'common'";
@@ -897,13 +1188,22 @@ static void mapZippedMod(mz_zip_archive *zip, const std::string& zipfname, const
 	mrec->push_back(layer);
 	ModsAvailable.insert(std::make_pair(mrec->modInfo.getId(), mrec));
 }
+static void scanModZipMapped(SDL_RWops *rwops, const std::string& fullpath, std::shared_ptr<const void> mapping);
 /** now this scans a zip of mods or of a single mod
  * @param rwops - SDL_RWops to the zip data
  * @param fullpath - full path to associate with the .zip.
  */
 void scanModZipRW(SDL_RWops *rwops, const std::string& fullpath) {
+	scanModZipMapped(rwops, fullpath, nullptr);
+}
+/** scans a zip of mods or of a single mod, optionally backed by a memory mapping of the whole zip
+ * @param rwops - SDL_RWops to the zip data
+ * @param fullpath - full path to associate with the .zip.
+ * @param mapping - memory mapping of the .zip, kept alive as long as the zip is used.
+ */
+static void scanModZipMapped(SDL_RWops *rwops, const std::string& fullpath, std::shared_ptr<const void> mapping) {
 	std::string log_ctx = "scanModZipRW(rwops, " + fullpath + "): ";
-	mz_zip_archive *mzip = newZipContext(log_ctx, rwops);
+	mz_zip_archive *mzip = newZipContext(log_ctx, rwops, std::move(mapping));
 
 	if (!mzip) { return; }
 	// check if this is maybe a zip of a single mod (metadata.yml at the top level)
@@ -933,6 +1233,15 @@ void scanModZipRW(SDL_RWops *rwops, const std::string& fullpath) {
  */
 void scanModZip(const std::string& fullpath) {
 	std::string log_ctx = "scanModZip(" + fullpath + "): ";
+	FileView view;
+	if (mapFileView(fullpath, view) && view.size <= INT_MAX) {
+		// central directory and stored entries are read straight from mapped memory
+		SDL_RWops *rwops = SDL_RWFromConstMem(view.data, (int)view.size);
+		if (rwops) {
+			scanModZipMapped(rwops, fullpath, view.owner);
+			return;
+		}
+	}
 	SDL_RWops *rwops = SDL_RWFromFile(fullpath.c_str(), "r");
 	if (!rwops) {
 		Log(LOG_WARNING) << log_ctx << "Ignoring zip: " << SDL_GetError();
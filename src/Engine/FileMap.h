@@ -53,6 +53,9 @@ namespace FileMap
 		std::unique_ptr<std::istream> getIStream() const;
 		YAML::Node getYAML() const;
 		std::vector<YAML::Node> getAllYAML() const;
+
+		/// Get value that change when file content change.
+		Uint64 getStamp() const;
 	};
 
 	/// For common operations on bunches of filenames
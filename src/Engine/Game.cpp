@@ -33,11 +33,13 @@
 #include "../Mod/Mod.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SaveWriter.h"
 #include "Action.h"
 #include "Exception.h"
 #include "Options.h"
 #include "CrossPlatform.h"
 #include "FileMap.h"
+#include "AsyncLoader.h"
 #include "Unicode.h"
 #include "../Menu/NotesState.h"
 #include "../Menu/TestState.h"
@@ -54,7 +56,7 @@ const double Game::VOLUME_GRADIENT = 10.0;
  * creates the display screen and sets up the cursor.
  * @param title Title of the game window.
  */
-Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _update(false),  _mouseActive(true), _timeUntilNextFrame(0)
+Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _update(false), _exitCode(EXIT_SUCCESS), _mouseActive(true), _timeUntilNextFrame(0)
 {
 	Options::reload = false;
 	Options::mute = false;
@@ -138,6 +140,8 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
  */
 Game::~Game()
 {
+	// don't quit with a save half written
+	SaveWriter::getShared().wait();
 	Sound::stop();
 	Music::stop();
 
@@ -413,7 +417,14 @@ void Game::quit()
 	if (_save != 0 && _save->isIronman() && !_save->getName().empty())
 	{
 		std::string filename = CrossPlatform::sanitizeFilename(_save->getName()) + ".sav";
-		_save->save(filename, _mod);
+		// older save of same file still queued must not overwrite this one
+		SaveWriter::getShared().wait();
+		YAML::Node brief;
+		std::string err = SaveWriter::write(filename, _save->save(_mod, brief), brief);
+		if (!err.empty())
+		{
+			throw Exception(err);
+		}
 	}
 	_quit = true;
 }
@@ -481,6 +492,10 @@ void Game::setState(State *state)
 	{
 		popState();
 	}
+	if (AsyncLoader *loader = AsyncLoader::findShared())
+	{
+		loader->evict(); // nobody in new scene waits for old prefetches
+	}
 	pushState(state);
 	_init = false;
 }
@@ -552,6 +567,26 @@ bool Game::isState(State *state) const
 	return !_states.empty() && _states.back() == state;
 }
 
+/**
+ * Checks if a state is anywhere in the state stack,
+ * not only on top of it.
+ * @param state Pointer to the state.
+ * @return Is the state in the stack?
+ */
+bool Game::hasState(State *state) const
+{
+	return std::find(_states.begin(), _states.end(), state) != _states.end();
+}
+
+/**
+ * Gets the state on top of the state stack.
+ * @return Pointer to the state, or null if the stack is empty.
+ */
+State *Game::getTopState() const
+{
+	return _states.empty() ? 0 : _states.back();
+}
+
 /**
  * Checks if the game is currently quitting.
  * @return whether the game is shutting down or not.
@@ -50,6 +50,7 @@ private:
 	SavedGame *_save;
 	Mod *_mod;
 	bool _quit, _init, _update;
+	int _exitCode;
 	FpsCounter *_fpsCounter;
 	bool _mouseActive;
 	unsigned int _timeOfLastFrame;
@@ -98,6 +99,10 @@ public:
 	void setMouseActive(bool active);
 	/// Returns whether current state is the param state
 	bool isState(State *state) const;
+	/// Returns whether the param state is anywhere in the state stack
+	bool hasState(State *state) const;
+	/// Returns the state on top of the state stack
+	State *getTopState() const;
 	/// Returns whether the game is shutting down.
 	bool isQuitting() const;
 	/// Loads the default and current language.
@@ -108,6 +113,10 @@ public:
 	void setUpdateFlag(bool update) { _update = update; }
 	/// Returns the update flag.
 	bool getUpdateFlag() const { return _update; }
+	/// Sets the process exit code.
+	void setExitCode(int exitCode) { _exitCode = exitCode; }
+	/// Returns the process exit code.
+	int getExitCode() const { return _exitCode; }
 };
 
 }
@@ -55,6 +55,16 @@ std::string _masterMod;
 int _passwordCheck = -1;
 bool _loadLastSave = false;
 bool _loadLastSaveExpended = false;
+std::string _simulateSave;
+int _simulateDays = 30;
+std::string _simulateBattle;
+int _simulateTurns = 10;
+unsigned long long _simulateSeed = 1;
+std::string _recordBattle;
+std::string _replayBattle;
+bool _replayBattleExpended = false;
+bool _replayRender = false;
+std::string _selfTest;
 
 /**
  * Sets up the options by creating their OptionInfo metadata.
@@ -77,6 +87,8 @@ void create()
 
 	_info.push_back(OptionInfo("maxFrameSkip", &maxFrameSkip, 5));
 	_info.push_back(OptionInfo("traceAI", &traceAI, false));
+	_info.push_back(OptionInfo("verifyFOV", &verifyFOV, false));
+	_info.push_back(OptionInfo("verifyLineBatch", &verifyLineBatch, false));
 	_info.push_back(OptionInfo("verboseLogging", &verboseLogging, false));
 	_info.push_back(OptionInfo("listVFSContents", &listVFSContents, false));
 	_info.push_back(OptionInfo("embeddedOnly", &embeddedOnly, true));
@@ -230,6 +242,15 @@ void create()
 	_info.push_back(OptionInfo("oxceEnableSlackingIndicator", &oxceEnableSlackingIndicator, true));
 	_info.push_back(OptionInfo("oxceEnablePaletteFlickerFix", &oxceEnablePaletteFlickerFix, false));
 	_info.push_back(OptionInfo("oxcePersonalLayoutIncludingArmor", &oxcePersonalLayoutIncludingArmor, true));
+	_info.push_back(OptionInfo("oxceScriptDirectDispatch", &oxceScriptDirectDispatch, false));
+	_info.push_back(OptionInfo("oxceScriptProfile", &oxceScriptProfile, false));
+	_info.push_back(OptionInfo("oxceRulesetCache", &oxceRulesetCache, false));
+	_info.push_back(OptionInfo("oxceSurfaceSetAtlas", &oxceSurfaceSetAtlas, false));
+	_info.push_back(OptionInfo("oxceAsyncLoader", &oxceAsyncLoader, true));
+	_info.push_back(OptionInfo("oxceAsyncSave", &oxceAsyncSave, true));
+	_info.push_back(OptionInfo("oxceFastScaler", &oxceFastScaler, true));
+	_info.push_back(OptionInfo("oxceUnitIndex", &oxceUnitIndex, true));
+	_info.push_back(OptionInfo("oxceGlobeIndex", &oxceGlobeIndex, true));
 
 	// OXCE hidden but moddable
 	_info.push_back(OptionInfo("oxceStartUpTextMode", &oxceStartUpTextMode, 0, "", "HIDDEN"));
@@ -505,6 +526,42 @@ static void loadArgs()
 				{
 					_masterMod = argv[i];
 				}
+				else if (argname == "simulate")
+				{
+					_simulateSave = argv[i];
+				}
+				else if (argname == "simdays")
+				{
+					_simulateDays = std::max(1, atoi(argv[i].c_str()));
+				}
+				else if (argname == "simbattle")
+				{
+					_simulateBattle = argv[i];
+				}
+				else if (argname == "simturns")
+				{
+					_simulateTurns = std::max(1, atoi(argv[i].c_str()));
+				}
+				else if (argname == "simseed")
+				{
+					_simulateSeed = strtoull(argv[i].c_str(), 0, 10);
+				}
+				else if (argname == "recordbattle")
+				{
+					_recordBattle = argv[i];
+				}
+				else if (argname == "replaybattle")
+				{
+					_replayBattle = argv[i];
+				}
+				else if (argname == "replayrender")
+				{
+					_replayRender = atoi(argv[i].c_str()) != 0;
+				}
+				else if (argname == "selftest")
+				{
+					_selfTest = argv[i];
+				}
 				else
 				{
 					//save this command line option for now, we will apply it later
@@ -537,6 +594,24 @@ static bool showHelp()
 	help << "        use PATH as the default Config Folder instead of auto-detecting" << std::endl << std::endl;
 	help << "-master MOD" << std::endl;
 	help << "        set MOD to the current master mod (eg. -master xcom2)" << std::endl << std::endl;
+	help << "-simulate SAVE" << std::endl;
+	help << "        run the geoscape of SAVE without a window and log timings (eg. -simulate autosave_geoscape.asav)" << std::endl << std::endl;
+	help << "-simdays DAYS" << std::endl;
+	help << "        number of game days to simulate with -simulate (default 30)" << std::endl << std::endl;
+	help << "-simbattle SAVE" << std::endl;
+	help << "        play the battle of SAVE with the AI on all sides without a window and log timings" << std::endl << std::endl;
+	help << "-simturns TURNS" << std::endl;
+	help << "        number of turns to simulate with -simbattle (default 10)" << std::endl << std::endl;
+	help << "-simseed SEED" << std::endl;
+	help << "        random seed for -simbattle, so runs can be compared (default 1)" << std::endl << std::endl;
+	help << "-recordbattle NAME" << std::endl;
+	help << "        save the battle at the first player input as NAME.sav and record the input into NAME.rec" << std::endl << std::endl;
+	help << "-replaybattle NAME" << std::endl;
+	help << "        play NAME.rec back on NAME.sav without a window, log timings and the final checksum and exit with an error if it does not match" << std::endl << std::endl;
+	help << "-replayrender 1" << std::endl;
+	help << "        show the replay of -replaybattle in the window instead" << std::endl << std::endl;
+	help << "-selftest NAME" << std::endl;
+	help << "        run the self-test or micro-benchmark NAME without a window, log the results and exit with an error if it fails" << std::endl << std::endl;
 	help << "-KEY VALUE" << std::endl;
 	help << "        override option KEY with VALUE (eg. -displayWidth 640)" << std::endl << std::endl;
 	help << "-help" << std::endl;
@@ -863,6 +938,61 @@ void expendLoadLastSave()
 	_loadLastSaveExpended = true;
 }
 
+const std::string &getSimulateSave()
+{
+	return _simulateSave;
+}
+
+int getSimulateDays()
+{
+	return _simulateDays;
+}
+
+const std::string &getSimulateBattle()
+{
+	return _simulateBattle;
+}
+
+int getSimulateTurns()
+{
+	return _simulateTurns;
+}
+
+unsigned long long getSimulateSeed()
+{
+	return _simulateSeed;
+}
+
+const std::string &getRecordBattle()
+{
+	return _recordBattle;
+}
+
+std::string getReplayBattle()
+{
+	return _replayBattleExpended ? std::string() : _replayBattle;
+}
+
+void expendReplayBattle()
+{
+	_replayBattleExpended = true;
+}
+
+bool getReplayRender()
+{
+	return _replayRender;
+}
+
+const std::string &getSelfTest()
+{
+	return _selfTest;
+}
+
+bool getHeadless()
+{
+	return !_simulateSave.empty() || !_simulateBattle.empty() || (!_replayBattle.empty() && !_replayRender) || !_selfTest.empty();
+}
+
 /**
  * Sets up the game's Data folder where the data file
  * are loaded from and the User folder and Config
@@ -116,6 +116,28 @@ namespace Options
 	bool getLoadLastSave();
 	/// And do it only at startup
 	void expendLoadLastSave();
+	/// Gets the save to run a headless geoscape simulation on, if any.
+	const std::string &getSimulateSave();
+	/// Gets the number of days for the headless geoscape simulation.
+	int getSimulateDays();
+	/// Gets the save to run a headless battlescape simulation on, if any.
+	const std::string &getSimulateBattle();
+	/// Gets the number of turns for the headless battlescape simulation.
+	int getSimulateTurns();
+	/// Gets the random seed for the headless battlescape simulation.
+	unsigned long long getSimulateSeed();
+	/// Gets the name to record the player's battle input into, if any.
+	const std::string &getRecordBattle();
+	/// Gets the name of the battle recording to replay, if any.
+	std::string getReplayBattle();
+	/// And do it only once
+	void expendReplayBattle();
+	/// Should the replay be shown in the window?
+	bool getReplayRender();
+	/// Gets the self-test to run, if any.
+	const std::string &getSelfTest();
+	/// Is the game running without a window for a simulation or replay?
+	bool getHeadless();
 }
 
 }
@@ -499,3 +499,58 @@ void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_
 	}
 }
 
+/**
+ * Apply the Scale effect on a horizontal slice of a bitmap.
+ * Only the source rows from y_first to y_last - 1 are scaled, the rows around the slice
+ * are still read, so the slices of one bitmap can be processed by different threads.
+ * The result is the same as the one of ::scale() for the same rows.
+ * \param scale Scale factor. 2, 203 (for 2x3), 204 (for 2x4) or 3. Scale4x isn't supported.
+ * \param void_dst Pointer at the first pixel of the destination bitmap.
+ * \param dst_slice Size in bytes of a destination bitmap row.
+ * \param void_src Pointer at the first pixel of the source bitmap.
+ * \param src_slice Size in bytes of a source bitmap row.
+ * \param pixel Bytes per pixel of the source and destination bitmap.
+ * \param width Horizontal size in pixels of the source bitmap.
+ * \param height Vertical size in pixels of the source bitmap.
+ * \param y_first First source row of the slice.
+ * \param y_last Source row after the end of the slice.
+ */
+void scale_slice(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height, unsigned y_first, unsigned y_last)
+{
+	unsigned char* dst = (unsigned char*)void_dst;
+	const unsigned char* src = (const unsigned char*)void_src;
+	unsigned y;
+
+	assert(height >= 2);
+
+	if (y_last > height)
+		y_last = height;
+
+	for (y = y_first; y < y_last; ++y) {
+		const unsigned char* prev = SCSRC(y > 0 ? y - 1 : 0);
+		const unsigned char* curr = SCSRC(y);
+		const unsigned char* next = SCSRC(y + 1 < height ? y + 1 : y);
+
+		switch (scale) {
+		case 202 :
+		case 2 :
+			stage_scale2x(SCDST(2 * y), SCDST(2 * y + 1), prev, curr, next, pixel, width);
+			break;
+		case 203 :
+			stage_scale2x3(SCDST(3 * y), SCDST(3 * y + 1), SCDST(3 * y + 2), prev, curr, next, pixel, width);
+			break;
+		case 204 :
+			stage_scale2x4(SCDST(4 * y), SCDST(4 * y + 1), SCDST(4 * y + 2), SCDST(4 * y + 3), prev, curr, next, pixel, width);
+			break;
+		case 303 :
+		case 3 :
+			stage_scale3x(SCDST(3 * y), SCDST(3 * y + 1), SCDST(3 * y + 2), prev, curr, next, pixel, width);
+			break;
+		}
+	}
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	scale2x_mmx_emms();
+#endif
+}
+
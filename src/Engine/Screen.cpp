@@ -235,6 +235,7 @@ void Screen::flip()
  */
 void Screen::clear()
 {
+	Zoom::resetLastFrame();
 	Surface::CleanSdlSurface(_surface.get());
 	Surface::CleanSdlSurface(_screen);
 }
@@ -369,6 +370,7 @@ void Screen::resetDisplay(bool resetVideo, bool noShaders)
 		}
 #endif
 		Log(LOG_INFO) << "Attempting to set display to " << width << "x" << height << "x" << _bpp << "...";
+		Zoom::resetLastFrame();
 		_screen = SDL_SetVideoMode(width, height, _bpp, _flags);
 		if (_screen == 0)
 		{
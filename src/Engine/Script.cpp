@@ -24,6 +24,7 @@
 #include <cmath>
 #include <bitset>
 #include <array>
+#include <chrono>
 
 #include "Logger.h"
 #include "Options.h"
@@ -33,6 +34,7 @@
 #include "ShaderDraw.h"
 #include "ShaderMove.h"
 #include "Exception.h"
+#include "CrossPlatform.h"
 #include "../fallthrough.h"
 
 namespace OpenXcom
@@ -441,6 +443,161 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 	return;
 }
 
+/**
+ * Macro used for creating list of all operations.
+ */
+#define MACRO_FUNC_ARRAY(NAME, ...) + helper::FuncGroup<MACRO_FUNC_ID(NAME)>::FuncList{}
+
+/**
+ * Type list of all script operations, index is operation id.
+ */
+using ScriptOpList = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY));
+
+#undef MACRO_FUNC_ARRAY
+
+/**
+ * Create table of all script operations.
+ */
+template<size_t... I>
+static constexpr std::array<ScriptOp, sizeof...(I)> scriptOpTableImpl(std::index_sequence<I...>)
+{
+	return {{ ScriptOp{ &helper::GetType<ScriptOpList, I>::func, helper::GetType<ScriptOpList, I>::offset + 1 }... }};
+}
+
+/**
+ * Table of all script operations, index is operation id.
+ */
+static const std::array<ScriptOp, 256> scriptOpTable = scriptOpTableImpl(std::make_index_sequence<256>{});
+
+/**
+ * Decode script operations to table of direct calls.
+ * @param code Output table, have entries at positions where operations start.
+ * @param proc Array storing operations of script.
+ * @param size Size of operation part of proc array.
+ */
+static void scriptDecode(std::vector<ScriptOp>& code, const Uint8* proc, size_t size)
+{
+	code.assign(size, ScriptOp{ nullptr, 0 });
+	for (size_t pos = 0; pos < size; pos += code[pos].size)
+	{
+		code[pos] = scriptOpTable[proc[pos]];
+	}
+}
+
+/**
+ * Alternative function executing scripts, it call operations directly from decoded table without decoding them every time.
+ * @param proc Array storing operation of script.
+ * @param code Decoded operations of script.
+ */
+static inline void scriptExeDirect(ScriptWorkerBase& data, const Uint8* proc, const ScriptOp* code)
+{
+	ProgPos curr = ProgPos::Start;
+	while (true)
+	{
+		const auto start = curr;
+		const auto& op = code[(int)curr];
+		const auto p = proc + (int)curr + 1;
+		curr += op.size;
+		const auto ret = op.func(data, p, curr);
+		if (ret != RetContinue)
+		{
+			if (ret != RetEnd)
+			{
+				static int bugCount = 0;
+				if (++bugCount < 100)
+				{
+					Log(LOG_ERROR) << "Invalid script operation for OpId: " << std::hex << std::showbase << (int)proc[(int)start] <<" at "<< (int)start;
+				}
+			}
+			return;
+		}
+	}
+}
+
+/**
+ * Execute script using decoded operations if they are available.
+ * @param proc Array storing operation of script.
+ * @param code Decoded operations of script or null.
+ */
+static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc, const ScriptOp* code)
+{
+	if (code)
+	{
+		scriptExeDirect(data, proc, code);
+	}
+	else
+	{
+		scriptExe(data, proc);
+	}
+}
+
+/// Functions called around every script run on this thread, null when nobody times scripts.
+static thread_local void (*scriptRunBegin)() = nullptr;
+static thread_local void (*scriptRunEnd)() = nullptr;
+
+/**
+ * Run script and record its execution time when profiling is enabled.
+ */
+static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc, const ScriptOp* code, ScriptProfile* profile)
+{
+	void (*runEnd)() = scriptRunEnd;
+	if (runEnd)
+	{
+		scriptRunBegin();
+	}
+	if (profile)
+	{
+		auto start = std::chrono::steady_clock::now();
+		scriptExe(data, proc, code);
+		auto end = std::chrono::steady_clock::now();
+		profile->add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+	else
+	{
+		scriptExe(data, proc, code);
+	}
+	if (runEnd)
+	{
+		runEnd();
+	}
+}
+
+
+/**
+ * Add time of one call.
+ * @param ns time in nanoseconds.
+ */
+void ScriptProfile::add(Uint64 ns)
+{
+	auto sample = (Uint32)std::min(ns, (Uint64)std::numeric_limits<Uint32>::max());
+	if (samples.size() < SampleLimit)
+	{
+		samples.push_back(sample);
+	}
+	else
+	{
+		samples[calls % SampleLimit] = sample;
+	}
+	calls += 1;
+	totalNs += ns;
+}
+
+/**
+ * Get 99th percentile of call time, calculated from recent calls.
+ * @return time in nanoseconds.
+ */
+Uint64 ScriptProfile::getPercentile99() const
+{
+	if (samples.empty())
+	{
+		return 0;
+	}
+	auto sorted = samples;
+	auto nth = sorted.begin() + (sorted.size() - 1) * 99 / 100;
+	std::nth_element(sorted.begin(), nth, sorted.end());
+	return *nth;
+}
+
 
 ////////////////////////////////////////////////////////////
 //						Script class
@@ -456,6 +613,7 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
  * @param dest destination surface.
  * @param x x offset of source surface.
  * @param y y offset of source surface.
+ * If scripts do not read destination pixel, result for each source color is computed only once.
  */
 void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, int shade, GraphSubset mask)
 {
@@ -464,7 +622,57 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 
 	destShader.setDomain(mask);
 
-	if (_proc)
+	if (_proc && _srcOnly)
+	{
+		// script do not see destination, so it's enough to run it once for each used color
+		int colors[256];
+		bool colorsDone[256] = { };
+		ShaderDrawFunc(
+			[&](Uint8& destStuff, const Uint8& srcStuff)
+			{
+				if (srcStuff)
+				{
+					if (!colorsDone[srcStuff])
+					{
+						ScriptWorkerBlit::Output arg = { srcStuff, 0 };
+						set(arg);
+						if (_events)
+						{
+							auto ptr = _events;
+							while (*ptr)
+							{
+								reset(arg);
+								scriptExe(*this, ptr->data(), ptr->code(), ptr->profile());
+								++ptr;
+							}
+							++ptr;
+
+							reset(arg);
+							scriptExe(*this, _proc, _code, _profile);
+
+							while (*ptr)
+							{
+								reset(arg);
+								scriptExe(*this, ptr->data(), ptr->code(), ptr->profile());
+								++ptr;
+							}
+						}
+						else
+						{
+							scriptExe(*this, _proc, _code, _profile);
+						}
+						get(arg);
+						colors[srcStuff] = arg.getFirst();
+						colorsDone[srcStuff] = true;
+					}
+					if (colors[srcStuff]) destStuff = colors[srcStuff];
+				}
+			},
+			destShader,
+			srcShader
+		);
+	}
+	else if (_proc)
 	{
 		if (_events)
 		{
@@ -479,18 +687,18 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 						while (*ptr)
 						{
 							reset(arg);
-							scriptExe(*this, ptr->data());
+							scriptExe(*this, ptr->data(), ptr->code(), ptr->profile());
 							++ptr;
 						}
 						++ptr;
 
 						reset(arg);
-						scriptExe(*this, _proc);
+						scriptExe(*this, _proc, _code, _profile);
 
 						while (*ptr)
 						{
 							reset(arg);
-							scriptExe(*this, ptr->data());
+							scriptExe(*this, ptr->data(), ptr->code(), ptr->profile());
 							++ptr;
 						}
 						++ptr;
@@ -512,7 +720,7 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 					{
 						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
 						set(arg);
-						scriptExe(*this, _proc);
+						scriptExe(*this, _proc, _code, _profile);
 						get(arg);
 						if (arg.getFirst()) destStuff = arg.getFirst();
 					}
@@ -530,13 +738,36 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 
 /**
  * Execute script with two arguments.
+ * @param proc script data.
+ * @param code decoded operations, can be null.
+ * @param profile statistics updated by this call, null when profiling is disabled.
  * @return Result value from script.
  */
-void ScriptWorkerBase::executeBase(const Uint8* proc)
+void ScriptWorkerBase::executeBase(const Uint8* proc, const ScriptOp* code, ScriptProfile* profile)
 {
 	if (proc)
 	{
-		scriptExe(*this, proc);
+		scriptExe(*this, proc, code, profile);
+	}
+}
+
+/**
+ * Sets functions called before and after every script run on the calling thread,
+ * other threads are not affected.
+ * @param begin called before script, null to remove both.
+ * @param end called after script, null to remove both.
+ */
+void ScriptWorkerBase::setRunHooks(void (*begin)(), void (*end)())
+{
+	if (begin && end)
+	{
+		scriptRunBegin = begin;
+		scriptRunEnd = end;
+	}
+	else
+	{
+		scriptRunBegin = nullptr;
+		scriptRunEnd = nullptr;
 	}
 }
 
@@ -1762,7 +1993,8 @@ ParserWriter::ParserWriter(
 	parser(d),
 	refListCurr(),
 	regIndexUsed(regUsed),
-	constIndexUsed(-1)
+	constIndexUsed(-1),
+	argUsed(0)
 {
 
 }
@@ -1773,6 +2005,8 @@ ParserWriter::ParserWriter(
 void ParserWriter::relese()
 {
 	pushProc(Proc_exit);
+	const auto codeSize = static_cast<size_t>(getCurrPos());
+	container._argUsed = argUsed;
 	refLabels.forEachPosition(
 		[&](auto pos, ProgPos value)
 		{
@@ -1838,6 +2072,11 @@ void ParserWriter::relese()
 			updateReserved<ScriptText>(pos, ScriptText{ charPtr(start) });
 		}
 	);
+
+	if (Options::oxceScriptDirectDispatch)
+	{
+		scriptDecode(container._code, container._proc.data(), codeSize);
+	}
 }
 
 /**
@@ -1851,6 +2090,14 @@ ScriptRefData ParserWriter::getReferece(const ScriptRef& s) const
 	if (ptr == nullptr)
 	{
 		ptr = parser.getRef(s);
+		if (ptr && ptr->isValueType<RegEnum>())
+		{
+			auto arg = parser.getArgIndex(ptr->getValue<RegEnum>());
+			if (arg >= 0)
+			{
+				argUsed |= (1u << arg);
+			}
+		}
 	}
 	if (ptr == nullptr)
 	{
@@ -2308,6 +2555,7 @@ void ScriptParserBase::addScriptReg(const std::string& s, ArgEnum type, bool wri
 		}
 		auto old = meta.nextRegPos(_regUsedSpace);
 		_regUsedSpace = meta.needRegSpace(_regUsedSpace);
+		_regArgs.push_back(static_cast<RegEnum>(old));
 		addSortHelper(_refList, { name, type, static_cast<RegEnum>(old) });
 	}
 	else
@@ -2447,6 +2695,23 @@ const ScriptRefData* ScriptParserBase::getRef(ScriptRef prefix, ScriptRef postfi
 	return findSortHelper(_refList, prefix, postfix);
 }
 
+/**
+ * Get position of register in argument list.
+ * @param reg Register of argument.
+ * @return Index of argument or -1 if register is not argument.
+ */
+int ScriptParserBase::getArgIndex(RegEnum reg) const
+{
+	for (size_t i = 0; i < _regArgs.size(); ++i)
+	{
+		if (_regArgs[i] == reg)
+		{
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
 /**
  * Parse string and write script to ScriptBase
  * @param src struct where final script is write to
@@ -2489,6 +2754,10 @@ bool ScriptParserBase::parseBase(ScriptContainerBase& destScript, const std::str
 				Log(LOG_ERROR) << err << "script need to end with return statement";
 			}
 			help.relese();
+			if (Options::oxceScriptProfile)
+			{
+				tempScript._profile = _shared->getProfile(_name);
+			}
 			destScript = std::move(tempScript);
 			return true;
 		}
@@ -3170,6 +3439,51 @@ void ScriptGlobal::endLoad()
 	_parserEvents.clear();
 }
 
+/**
+ * Get profile statistics for scripts of hook from current mod.
+ * @param hook name of script hook.
+ * @return statistics shared by all scripts of this hook from this mod.
+ */
+ScriptProfile* ScriptGlobal::getProfile(const std::string& hook)
+{
+	auto mod = getProfileMod();
+	auto& p = _profiles[std::make_pair(hook, mod)];
+	if (p.hook.empty())
+	{
+		p.hook = hook;
+		p.modOffset = mod;
+		p.modName = getProfileModName(mod);
+	}
+	return &p;
+}
+
+/**
+ * Save collected profile statistics to CSV file.
+ * @param fileName path to file.
+ */
+void ScriptGlobal::saveProfile(const std::string& fileName) const
+{
+	std::ostringstream out;
+	out << "hook,mod,offset,calls,total_ns,avg_ns,p99_ns\n";
+	for (auto& i : _profiles)
+	{
+		auto& p = i.second;
+		if (p.calls == 0)
+		{
+			continue;
+		}
+		out << p.hook << "," << p.modName << "," << p.modOffset << "," << p.calls << "," << p.totalNs << "," << (p.totalNs / p.calls) << "," << p.getPercentile99() << "\n";
+	}
+	if (CrossPlatform::writeFile(fileName, out.str()))
+	{
+		Log(LOG_INFO) << "Script profile saved to: " << fileName;
+	}
+	else
+	{
+		Log(LOG_ERROR) << "Failed to save script profile to: " << fileName;
+	}
+}
+
 /**
  * Load global data from YAML.
  */
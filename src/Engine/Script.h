@@ -116,6 +116,44 @@ const inline ScriptText ScriptText::empty = { "" };
 
 using ScriptFunc = RetEnum (*)(ScriptWorkerBase&, const Uint8*, ProgPos&);
 
+/**
+ * Decoded script operation, used by direct dispatch of scripts.
+ */
+struct ScriptOp
+{
+	/// Function implementing operation.
+	ScriptFunc func;
+	/// Size of operation and its arguments in proc vector.
+	int size;
+};
+
+/**
+ * Execution statistics of scripts from one hook defined by one mod.
+ */
+struct ScriptProfile
+{
+	/// Max number of recent call times kept for percentile.
+	static constexpr size_t SampleLimit = 8192;
+
+	/// Name of script hook.
+	std::string hook;
+	/// Offset of mod that define scripts.
+	int modOffset = 0;
+	/// Name of mod that define scripts.
+	std::string modName;
+	/// Number of calls.
+	Uint64 calls = 0;
+	/// Total time of all calls in nanoseconds.
+	Uint64 totalNs = 0;
+	/// Times of recent calls in nanoseconds.
+	std::vector<Uint32> samples;
+
+	/// Add time of one call.
+	void add(Uint64 ns);
+	/// Get 99th percentile of call time in nanoseconds.
+	Uint64 getPercentile99() const;
+};
+
 /**
  * Script execution counter.
  */
@@ -373,7 +411,11 @@ struct TypeInfo
 class ScriptContainerBase
 {
 	friend struct ParserWriter;
+	friend class ScriptParserBase;
 	std::vector<Uint8> _proc;
+	std::vector<ScriptOp> _code;
+	Uint32 _argUsed = 0;
+	ScriptProfile* _profile = nullptr;
 
 public:
 	/// Constructor.
@@ -402,6 +444,22 @@ public:
 	{
 		return *this ? _proc.data() : nullptr;
 	}
+	/// Get pointer to decoded operations, null if script use interpreter.
+	const ScriptOp* code() const
+	{
+		return _code.empty() ? nullptr : _code.data();
+	}
+	/// Get profile statistics, null if profiling is disabled.
+	ScriptProfile* profile() const
+	{
+		return _profile;
+	}
+
+	/// Test if script code reference argument, index is position in parser argument list.
+	bool isArgUsed(int i) const
+	{
+		return _argUsed & (1u << i);
+	}
 };
 
 /**
@@ -444,11 +502,45 @@ public:
 	{
 		return _current.data();
 	}
+	/// Get pointer to decoded operations.
+	const ScriptOp* code() const
+	{
+		return _current.code();
+	}
+	/// Get profile statistics.
+	ScriptProfile* profile() const
+	{
+		return _current.profile();
+	}
 	/// Get pointer to proc data.
 	const ScriptContainerBase* dataEvents() const
 	{
 		return _events;
 	}
+
+	/// Test if script or any of events reference argument, index is position in parser argument list.
+	bool isArgUsed(int i) const
+	{
+		if (_current.isArgUsed(i))
+		{
+			return true;
+		}
+		if (auto ptr = _events)
+		{
+			// events before and after script, each list end with empty script
+			for (int list = 0; list < 2; ++list, ++ptr)
+			{
+				for (; *ptr; ++ptr)
+				{
+					if (ptr->isArgUsed(i))
+					{
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
 };
 
 /**
@@ -699,7 +791,7 @@ protected:
 	}
 
 	/// Call script.
-	void executeBase(const Uint8* proc);
+	void executeBase(const Uint8* proc, const ScriptOp* code, ScriptProfile* profile);
 
 public:
 	/// Default constructor.
@@ -727,6 +819,9 @@ public:
 	void log_buffer_add(FuncRef<std::string()> func);
 	/// Flush buffer to log file.
 	void log_buffer_flush(ProgPos& p);
+
+	/// Set functions called around every script run on the calling thread.
+	static void setRunHooks(void (*begin)(), void (*end)());
 };
 
 /**
@@ -758,7 +853,7 @@ public:
 		static_assert(std::is_same<typename Parent::Output, Output>::value, "Incompatible script output type");
 
 		set(arg);
-		executeBase(c.data());
+		executeBase(c.data(), c.code(), c.profile());
 		get(arg);
 	}
 
@@ -775,19 +870,19 @@ public:
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeBase(ptr->data(), ptr->code(), ptr->profile());
 				++ptr;
 			}
 			++ptr;
 		}
 		reset(arg);
-		executeBase(c.data());
+		executeBase(c.data(), c.code(), c.profile());
 		if (ptr)
 		{
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeBase(ptr->data(), ptr->code(), ptr->profile());
 				++ptr;
 			}
 		}
@@ -802,14 +897,21 @@ class ScriptWorkerBlit : public ScriptWorkerBase
 {
 	/// Current script set in worker.
 	const Uint8* _proc;
+	const ScriptOp* _code;
+	ScriptProfile* _profile;
 	const ScriptContainerBase* _events;
+	/// Scripts do not read destination pixel, result depend only on source color.
+	bool _srcOnly;
+
+	/// Position of destination pixel in argument list.
+	static constexpr int ArgDestPixel = 1;
 
 public:
 	/// Type of output value from script.
 	using Output = ScriptOutputArgs<int&, int>;
 
 	/// Default constructor.
-	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr)
+	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _code(nullptr), _profile(nullptr), _events(nullptr), _srcOnly(false)
 	{
 
 	}
@@ -823,7 +925,10 @@ public:
 		if (c)
 		{
 			_proc = c.data();
+			_code = c.code();
+			_profile = c.profile();
 			_events = nullptr;
+			_srcOnly = !c.isArgUsed(ArgDestPixel);
 			updateBase<Output>(args...);
 		}
 	}
@@ -837,7 +942,10 @@ public:
 		if (c)
 		{
 			_proc = c.data();
+			_code = c.code();
+			_profile = c.profile();
 			_events = c.dataEvents();
+			_srcOnly = !c.isArgUsed(ArgDestPixel);
 			updateBase<Output>(args...);
 		}
 	}
@@ -851,7 +959,10 @@ public:
 	void clear()
 	{
 		_proc = nullptr;
+		_code = nullptr;
+		_profile = nullptr;
 		_events = nullptr;
+		_srcOnly = false;
 	}
 };
 
@@ -1145,6 +1256,7 @@ class ScriptParserBase
 	size_t _regUsedSpace;
 	Uint8 _regOutSize;
 	ScriptRef _regOutName[ScriptMaxOut];
+	std::vector<RegEnum> _regArgs;
 	std::string _name;
 	std::string _defaultScript;
 	std::vector<std::vector<char>> _strings;
@@ -1308,6 +1420,8 @@ public:
 	Uint8 getParamSize() const { return _regOutSize; }
 	/// Get parameter data.
 	const ScriptRefData* getParamData(Uint8 i) const { return getRef(_regOutName[i]); }
+	/// Get position of register in argument list.
+	int getArgIndex(RegEnum reg) const;
 
 	/// Get name of type.
 	ScriptRef getTypeName(ArgEnum type) const;
@@ -1603,6 +1717,7 @@ private:
 	std::map<ArgEnum, TagData> _tagNames;
 	std::vector<TagValueType> _tagValueTypes;
 	std::vector<ScriptRefData> _refList;
+	std::map<std::pair<std::string, int>, ScriptProfile> _profiles;
 
 	/// Get tag value.
 	size_t getTag(ArgEnum type, ScriptRef s) const;
@@ -1685,6 +1800,15 @@ public:
 	/// Finishing loading data.
 	virtual void endLoad();
 
+	/// Get offset of mod that currently load scripts.
+	virtual int getProfileMod() const { return 0; }
+	/// Get name of mod with given offset.
+	virtual std::string getProfileModName(int /*offset*/) const { return ""; }
+	/// Get profile statistics for scripts of hook from current mod.
+	ScriptProfile* getProfile(const std::string& hook);
+	/// Save collected profile statistics to CSV file.
+	void saveProfile(const std::string& fileName) const;
+
 	/// Load global data from YAML.
 	void load(const YAML::Node& node);
 };
@@ -151,6 +151,8 @@ struct ParserWriter
 	size_t regIndexUsed;
 	/// negative index of used const values.
 	int constIndexUsed;
+	/// bit mask of script arguments referenced by code.
+	mutable Uint32 argUsed;
 
 	/// Store position of blocks of code like "if" or "while".
 	std::vector<Block> codeBlocks;
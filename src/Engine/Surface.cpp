@@ -24,7 +24,6 @@
 #include <SDL_gfxPrimitives.h>
 #include <SDL_image.h>
 #include <SDL_endian.h>
-#include "../lodepng.h"
 #include "Palette.h"
 #include "Exception.h"
 #include "Logger.h"
@@ -33,6 +32,7 @@
 #include <stdlib.h>
 #include "SDL2Helpers.h"
 #include "FileMap.h"
+#include "AsyncLoader.h"
 #ifdef _WIN32
 #include <malloc.h>
 #endif
@@ -201,13 +201,24 @@ void Surface::CleanSdlSurface(SDL_Surface* surface)
 		SDL_FillRect(surface, &c, 0);
 	}
 }
+/**
+ * Size of pixel buffer needed by 8bit surface, buffer size keep 16 byte alignment of next buffer.
+ * @param width width of surface
+ * @param height height of surface
+ * @return Size in bytes
+ */
+int Surface::GetBufferSize8Bit(int width, int height)
+{
+	return GetPitch(8, width) * height;
+}
+
 /**
  * Default deleter for alignment buffer
  * @param buffer
  */
 void Surface::UniqueBufferDeleter::operator ()(Uint8* buffer)
 {
-	if (buffer)
+	if (buffer && !borrowed)
 	{
 #ifdef _WIN32
 		_aligned_free(buffer);
@@ -282,6 +293,35 @@ Surface::Surface(const Surface& other) : Surface{ }
 	_redraw = other._redraw;
 }
 
+/**
+ * Performs a deep copy of an existing surface, pixels are stored in external buffer.
+ * @param other Surface to copy from.
+ * @param buffer Aligned buffer of size GetBufferSize8Bit, need to outlive this surface.
+ */
+Surface::Surface(const Surface& other, Uint8* buffer) : Surface{ }
+{
+	if (!other)
+	{
+		return;
+	}
+	int width = other.getWidth();
+	int height = other.getHeight();
+	_alignedBuffer = UniqueBufferPtr(buffer, UniqueBufferDeleter{ true });
+	_surface = NewSdlSurface(_alignedBuffer, 8, width, height);
+	_width = _surface->w;
+	_height = _surface->h;
+	_pitch = _surface->pitch;
+	SDL_SetColorKey(_surface.get(), SDL_SRCCOLORKEY, 0);
+	SDL_SetColors(_surface.get(), other.getPalette(), 0, 255);
+	RawCopySurf(_surface, other._surface);
+
+	_x = other._x;
+	_y = other._y;
+	_visible = other._visible;
+	_hidden = other._hidden;
+	_redraw = other._redraw;
+}
+
 /**
  * Deletes the surface from memory.
  */
@@ -367,6 +407,16 @@ void Surface::loadImage(const std::string &filename)
 	_surface = nullptr;
 
 	Log(LOG_VERBOSE) << "Loading image: " << filename;
+
+	// Image could be already decoded by background loader
+	StagedImage staged;
+	AsyncLoader *loader = AsyncLoader::findShared();
+	if (loader && loader->take(filename, staged))
+	{
+		loadStagedImage(staged, filename);
+		return;
+	}
+
 	auto rw = FileMap::getRWops(filename);
 	if (!rw) { return; } // relevant message gets logged in FileMap.
 
@@ -375,52 +425,16 @@ void Surface::loadImage(const std::string &filename)
 	{
 		size_t size;
 		void *data = SDL_LoadFile_RW(rw, &size, SDL_FALSE);
-		if ((data != NULL) && (size > 8 + 12 + 12)) // minimal PNG file size: header and two empty chunks
+		if (data != NULL)
 		{
-			std::vector<unsigned char> png;
-			png.resize(size);
-			memcpy(&png[0], data, size);
-
-			std::vector<unsigned char> image;
-			unsigned width, height;
-			lodepng::State state;
-			state.decoder.color_convert = 0;
-			unsigned error = lodepng::decode(image, width, height, state, png);
-			if (!error)
+			std::string error;
+			if (AsyncLoader::decodePng(data, size, staged, error))
 			{
-				LodePNGColorMode *color = &state.info_png.color;
-				unsigned bpp = lodepng_get_bpp(color);
-				if (bpp == 8)
-				{
-					*this = Surface(width, height, 0, 0);
-					setPalette((SDL_Color*)color->palette, 0, color->palettesize);
-
-					ShaderDrawFunc(
-						[](Uint8& dest, unsigned char& src)
-						{
-							dest = src;
-						},
-						ShaderSurface(this),
-						ShaderSurface(SurfaceRaw<unsigned char>(image, width, height))
-					);
-					int transparent = 0;
-					for (int c = 0; c < _surface->format->palette->ncolors; ++c)
-					{
-						SDL_Color *palColor = _surface->format->palette->colors + c;
-						if (palColor->unused == 0)
-						{
-							transparent = c;
-							break;
-						}
-					}
-					FixTransparent(_surface, transparent);
-					if (transparent != 0)
-					{
-						Log(LOG_WARNING) << "Image " << filename << " (from lodepng) has incorrect transparent color index " << transparent << " (instead of 0).";
-					}
-				}
-			} else {
-				Log(LOG_ERROR) << "Image " << filename << " lodepng failed:" << lodepng_error_text(error);
+				loadStagedImage(staged, filename);
+			}
+			else if (!error.empty())
+			{
+				Log(LOG_ERROR) << "Image " << filename << " lodepng failed:" << error;
 			}
 		}
 		if (data) { SDL_free(data); }
@@ -455,6 +469,37 @@ void Surface::loadImage(const std::string &filename)
 	}
 }
 
+/**
+ * Loads the contents of an image already decoded into memory.
+ * @param image Decoded pixels and palette.
+ * @param filename Filename of the image, used for warnings.
+ */
+void Surface::loadStagedImage(const StagedImage &image, const std::string &filename)
+{
+	*this = Surface(image.width, image.height, 0, 0);
+	setPalette(image.palette.data(), 0, (int)image.palette.size());
+
+	for (int y = 0; y < image.height; ++y)
+	{
+		memcpy((Uint8*)_surface->pixels + y * _surface->pitch, image.pixels.data() + y * image.width, image.width);
+	}
+	int transparent = 0;
+	for (int c = 0; c < _surface->format->palette->ncolors; ++c)
+	{
+		SDL_Color *palColor = _surface->format->palette->colors + c;
+		if (palColor->unused == 0)
+		{
+			transparent = c;
+			break;
+		}
+	}
+	FixTransparent(_surface, transparent);
+	if (transparent != 0)
+	{
+		Log(LOG_WARNING) << "Image " << filename << " (from lodepng) has incorrect transparent color index " << transparent << " (instead of 0).";
+	}
+}
+
 /**
  * Loads the contents of an X-Com SPK image file into
  * the surface. SPK files are compressed with a custom
@@ -32,6 +32,7 @@ class Font;
 class Language;
 class ScriptWorkerBase;
 class SurfaceCrop;
+struct StagedImage;
 template<typename Pixel> class SurfaceRaw;
 
 /**
@@ -46,6 +47,12 @@ class Surface
 public:
 	struct UniqueBufferDeleter
 	{
+		/// Buffer is part of memory owned by someone else, like atlas page of SurfaceSet.
+		bool borrowed;
+
+		UniqueBufferDeleter() : borrowed{ false } { }
+		UniqueBufferDeleter(bool b) : borrowed{ b } { }
+
 		void operator()(Uint8*);
 	};
 	struct UniqueSurfaceDeleter
@@ -80,6 +87,8 @@ public:
 
 	/// Zero whole surface.
 	static void CleanSdlSurface(SDL_Surface* surface);
+	/// Size of pixel buffer needed by 8bit surface.
+	static int GetBufferSize8Bit(int width, int height);
 
 protected:
 	UniqueBufferPtr _alignedBuffer;
@@ -102,6 +111,8 @@ public:
 	Surface(int width, int height, int x = 0, int y = 0);
 	/// Creates a new surface from an existing one.
 	Surface(const Surface& other);
+	/// Creates a copy of an existing surface that store its pixels in external buffer.
+	Surface(const Surface& other, Uint8* buffer);
 	/// Move surface to another place.
 	Surface(Surface&& other) = default;
 	/// Move assignment
@@ -129,6 +140,8 @@ public:
 	void loadBdy(const std::string &filename);
 	/// Loads a general image file.
 	void loadImage(const std::string &filename);
+	/// Loads an image decoded into memory.
+	void loadStagedImage(const StagedImage &image, const std::string &filename);
 	/// Clears the surface's contents with a specified colour.
 	void clear();
 	/// Offsets the surface's colors by a set amount.
@@ -18,6 +18,7 @@
  */
 #include "SurfaceSet.h"
 #include <climits>
+#include <algorithm>
 #include "Surface.h"
 #include "Exception.h"
 #include "FileMap.h"
@@ -25,6 +26,14 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Preferred size of one atlas page, bigger frames get separate page.
+const int AtlasPageSize = 1024 * 1024;
+
+}
+
 /**
  * Sets up a new empty surface set for frames of the specified size.
  * @param width Frame width in pixels.
@@ -287,6 +296,44 @@ size_t SurfaceSet::getTotalFrames() const
 	return _frames.size();
 }
 
+/**
+ * Moves pixels of all frames to few big atlas pages, frames are stored one after another
+ * in order of index, so drawing neighbour frames touch neighbour memory.
+ * Frames keep their size, palette and position, and are still normal surfaces.
+ * Frames added or replaced later use their own memory.
+ * Pages are allocated one by one while frames are moved, so peak memory
+ * use is only one page above the unpacked set.
+ */
+void SurfaceSet::pack()
+{
+	std::vector<Surface::UniqueBufferPtr> pages;
+
+	Uint8* pageCurr = nullptr;
+	int pageFree = 0;
+	for (size_t i = 0; i < _frames.size(); ++i)
+	{
+		const Surface& frame = _frames[i];
+		if (!frame)
+		{
+			continue;
+		}
+		const int size = Surface::GetBufferSize8Bit(frame.getWidth(), frame.getHeight());
+		if (size > pageFree)
+		{
+			const int pageSize = std::max(size, AtlasPageSize);
+			pages.push_back(Surface::NewAlignedBuffer(8, pageSize, 1));
+			pageCurr = pages.back().get();
+			pageFree = Surface::GetBufferSize8Bit(pageSize, 1);
+		}
+		// old pixels are freed right away, at most one frame is stored twice
+		_frames[i] = Surface(frame, pageCurr);
+		pageCurr += size;
+		pageFree -= size;
+	}
+
+	_pages = std::move(pages);
+}
+
 /**
  * Replaces a certain amount of colors in all of the frames.
  * @param colors Pointer to the set of colors.
@@ -21,12 +21,11 @@
 #include <vector>
 #include <string>
 #include <SDL.h>
+#include "Surface.h"
 
 namespace OpenXcom
 {
 
-class Surface;
-
 /**
  * Container of a set of surfaces.
  * Used to manage single images that contain series of
@@ -36,6 +35,7 @@ class Surface;
 class SurfaceSet
 {
 private:
+	std::vector<Surface::UniqueBufferPtr> _pages;
 	std::vector<Surface> _frames;
 	int _width, _height;
 	int _sharedFrames;
@@ -45,6 +45,8 @@ public:
 	SurfaceSet(int width, int height);
 	/// Creates a surface set from an existing one.
 	SurfaceSet(const SurfaceSet& other);
+	/// Replaces content with another surface set.
+	SurfaceSet& operator=(SurfaceSet&& other) = default;
 	/// Cleans up the surface set.
 	~SurfaceSet();
 	/// Loads an X-Com set of PCK/TAB image files.
@@ -67,6 +69,8 @@ public:
 
 	/// Gets the total frames in the set.
 	size_t getTotalFrames() const;
+	/// Moves pixels of all frames to few big atlas pages.
+	void pack();
 	/// Sets the surface set's palette.
 	void setPalette(const SDL_Color *colors, int firstcolor = 0, int ncolors = 256);
 };
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "WorkerPool.h"
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+namespace OpenXcom
+{
+
+/**
+ * Creates pool with given number of threads.
+ * @param threads Number of threads, zero means all work is done by caller.
+ */
+WorkerPool::WorkerPool(int threads) : _quit(false)
+{
+	for (int i = 0; i < threads; ++i)
+	{
+		_threads.emplace_back(&WorkerPool::work, this);
+	}
+}
+
+/**
+ * Finishes all queued tasks and stops threads.
+ */
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wake.notify_all();
+	for (auto &t : _threads)
+	{
+		t.join();
+	}
+}
+
+/**
+ * Main loop of worker thread, runs tasks until pool is destroyed.
+ */
+void WorkerPool::work()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [&]{ return _quit || !_tasks.empty(); });
+			if (_tasks.empty())
+			{
+				return;
+			}
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+		task();
+	}
+}
+
+/**
+ * Queues task to run on some worker thread.
+ * If pool do not have any threads, task is run immediately.
+ * @param task Task to run.
+ */
+void WorkerPool::push(std::function<void()> task)
+{
+	if (_threads.empty())
+	{
+		task();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_tasks.push_back(std::move(task));
+	}
+	_wake.notify_one();
+}
+
+/**
+ * Runs function for each part and waits until all are done.
+ * Calling thread works on parts too, so this is safe to call from worker threads.
+ * @param parts Number of parts.
+ * @param func Function called with index of each part.
+ */
+void WorkerPool::parallelFor(int parts, const std::function<void(int)> &func)
+{
+	const int helpers = std::min(parts - 1, getSize());
+	if (helpers <= 0)
+	{
+		for (int i = 0; i < parts; ++i)
+		{
+			func(i);
+		}
+		return;
+	}
+
+	// helpers can start after everything is already done, they can only touch shared state then
+	struct State
+	{
+		std::atomic<int> next{ 0 };
+		int finished = 0;
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+	auto state = std::make_shared<State>();
+	auto run = [state, parts, &func]()
+	{
+		int count = 0;
+		for (int i = state->next++; i < parts; i = state->next++)
+		{
+			func(i);
+			++count;
+		}
+		if (count)
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->finished += count;
+			if (state->finished == parts)
+			{
+				state->done.notify_all();
+			}
+		}
+	};
+
+	for (int i = 0; i < helpers; ++i)
+	{
+		push(run);
+	}
+	run();
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->done.wait(lock, [&]{ return state->finished == parts; });
+}
+
+/**
+ * Gets pool shared by whole game, one thread less than there are cores.
+ * @return Shared pool.
+ */
+WorkerPool &WorkerPool::getShared()
+{
+	static WorkerPool pool(std::min(std::max((int)std::thread::hardware_concurrency(), 1) - 1, 7));
+	return pool;
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace OpenXcom
+{
+
+/**
+ * Small pool of worker threads.
+ * Used to split heavy loops into independent parts and to run background tasks.
+ */
+class WorkerPool
+{
+private:
+	std::vector<std::thread> _threads;
+	std::deque<std::function<void()>> _tasks;
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	bool _quit;
+
+	/// Main loop of worker thread.
+	void work();
+public:
+	/// Creates pool with given number of threads.
+	WorkerPool(int threads);
+	/// Cleans up the pool, waits for all queued tasks.
+	~WorkerPool();
+	/// Gets number of worker threads.
+	int getSize() const { return (int)_threads.size(); }
+	/// Queues task to run on some worker thread.
+	void push(std::function<void()> task);
+	/// Runs function for each part and waits until all are done.
+	void parallelFor(int parts, const std::function<void(int)> &func);
+	/// Gets pool shared by whole game.
+	static WorkerPool &getShared();
+};
+
+}
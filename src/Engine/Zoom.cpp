@@ -19,10 +19,14 @@
 
 #include "Zoom.h"
 
+#include <algorithm>
+#include <vector>
+#include <cstring>
 #include "Surface.h"
 #include "Logger.h"
 #include "Options.h"
 #include "Screen.h"
+#include "WorkerPool.h"
 
 #include "OpenGL.h"
 
@@ -61,6 +65,84 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Copy of last source frame, used to skip scaling of frames that did not change.
+ */
+struct LastFrame
+{
+	std::vector<Uint8> pixels;
+	SDL_Surface *dst = nullptr;
+	int dstW = 0, dstH = 0;
+	int filter = 0;
+};
+
+LastFrame TheLastFrame;
+
+/**
+ * Split scaling of source rows to bands processed by worker threads.
+ * All scalers used here read rows around the band but write only its own
+ * rows of output, so bands do not need any synchronization.
+ * @param height Number of source rows.
+ * @param func Call back scaling rows from first to last - 1.
+ */
+template<typename BandFunc>
+void scaleBands(int height, BandFunc func)
+{
+	constexpr int minBandSize = 16;
+
+	auto& pool = WorkerPool::getShared();
+	const int bands = Options::oxceFastScaler ? std::max(1, std::min(pool.getSize() + 1, height / minBandSize)) : 1;
+	if (bands == 1)
+	{
+		func(0, height);
+		return;
+	}
+	pool.parallelFor(bands,
+		[&](int i)
+		{
+			func(height * i / bands, height * (i + 1) / bands);
+		}
+	);
+}
+
+/**
+ * Checks if source frame is same as the one already scaled to the same output surface.
+ * Remembers the frame when it is different.
+ * @param src Source surface.
+ * @param dst Output surface.
+ * @return True if output surface already holds this frame.
+ */
+bool isSameFrame(SDL_Surface *src, SDL_Surface *dst)
+{
+	// hardware surfaces can flip between several buffers, their content is not kept
+	if (!Options::oxceFastScaler || (dst->flags & SDL_HWSURFACE))
+	{
+		TheLastFrame.dst = nullptr;
+		return false;
+	}
+
+	const int filter = (Options::useScaleFilter ? 1 : 0) | (Options::useHQXFilter ? 2 : 0) | (Options::useXBRZFilter ? 4 : 0);
+	const size_t size = (size_t)src->pitch * src->h;
+	const Uint8 *pixels = (const Uint8 *)src->pixels;
+	if (TheLastFrame.dst == dst && TheLastFrame.dstW == dst->w && TheLastFrame.dstH == dst->h && TheLastFrame.filter == filter
+		&& TheLastFrame.pixels.size() == size && std::memcmp(TheLastFrame.pixels.data(), pixels, size) == 0)
+	{
+		return true;
+	}
+
+	TheLastFrame.pixels.assign(pixels, pixels + size);
+	TheLastFrame.dst = dst;
+	TheLastFrame.dstW = dst->w;
+	TheLastFrame.dstH = dst->h;
+	TheLastFrame.filter = filter;
+	return false;
+}
+
+} // namespace
+
 
 /**
  * Optimized 8-bit zoomer for resizing by a factor of 2. Doesn't flip.
@@ -647,6 +729,15 @@ bool Zoom::haveSSE2()
 
 #endif
 
+/**
+ * Forgets last scaled frame, needs to be called when output surface
+ * is cleared or recreated.
+ */
+void Zoom::resetLastFrame()
+{
+	TheLastFrame = LastFrame();
+}
+
 /**
  * Wrapper around various software and OpenGL screen buffer pushing functions which zoom.
  * Basically called just from Screen::flip()
@@ -677,7 +768,10 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	}
 	else if (topBlackBand <= 0 && bottomBlackBand <= 0 && leftBlackBand <= 0 && rightBlackBand <= 0)
 	{
-		_zoomSurfaceY(src, dst, 0, 0);
+		if (!isSameFrame(src, dst))
+		{
+			_zoomSurfaceY(src, dst, 0, 0);
+		}
 	}
 	else if (dstWidth == src->w && dstHeight == src->h)
 	{
@@ -732,7 +826,10 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 			{
 				if (dst->w == src->w * (int)factor && dst->h == src->h * (int)factor)
 				{
-					xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB);
+					scaleBands(src->h, [&](int yFirst, int yLast)
+					{
+						xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB, xbrz::ScalerCfg(), yFirst, yLast);
+					});
 					return 0;
 				}
 			}
@@ -752,19 +849,28 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 
 			if (dst->w == src->w * 2 && dst->h == src->h * 2)
 			{
-				hq2x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleBands(src->h, [&](int yFirst, int yLast)
+				{
+					hq2x_32_rb_slice((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 
 			if (dst->w == src->w * 3 && dst->h == src->h * 3)
 			{
-				hq3x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleBands(src->h, [&](int yFirst, int yLast)
+				{
+					hq3x_32_rb_slice((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 
 			if (dst->w == src->w * 4 && dst->h == src->h * 4)
 			{
-				hq4x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleBands(src->h, [&](int yFirst, int yLast)
+				{
+					hq4x_32_rb_slice((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 		}
@@ -777,7 +883,18 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 		{
 			if (dst->w == src->w * (int)factor && dst->h == src->h * (int)factor && !scale_precondition(factor, src->format->BytesPerPixel, src->w, src->h))
 			{
-				scale(factor, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
+				if (factor == 4)
+				{
+					// scale4x runs two passes over its own row buffer, it can't be split
+					scale(factor, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
+				}
+				else
+				{
+					scaleBands(src->h, [&](int yFirst, int yLast)
+					{
+						scale_slice(factor, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h, yFirst, yLast);
+					});
+				}
 				return 0;
 			}
 		}
@@ -34,6 +34,8 @@ class Zoom
 	static int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy);
 	/// Check for SSE2 instructions using CPUID.
 	static bool haveSSE2();
+	/// Forget last scaled frame.
+	static void resetLastFrame();
 
 private:
 
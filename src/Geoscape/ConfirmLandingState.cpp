@@ -131,6 +131,9 @@ ConfirmLandingState::ConfirmLandingState(Craft *craft, Texture *missionTexture,
 			sprites->getFrame(2)->blitNShade(_sprite, 0, 0);
 		}
 	}
+
+	// load battle resources while player reads the dialog
+	BattlescapeGenerator::prefetchResources(_game->getMod(), _craft);
 }
 
 /**
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GeoscapeSimulation.h"
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include "GeoscapeState.h"
+#include "ConfirmLandingState.h"
+#include "DogfightState.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Savegame/Craft.h"
+#include "../Savegame/SavedGame.h"
+#include "../fallthrough.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Initializes a simulation.
+ * @param game Pointer to the core game.
+ * @param owner State that runs the simulation, anything pushed above it gets discarded.
+ */
+GeoscapeSimulation::GeoscapeSimulation(Game *game, State *owner) : _game(game), _owner(owner), _geoscape(0), _popups(0), _interceptions(0), _battles(0)
+{
+	for (int i = 0; i <= TIME_1MONTH; ++i)
+	{
+		_time[i] = 0;
+		_calls[i] = 0;
+	}
+}
+
+/**
+ * Cleans up the simulation and drops the simulated game,
+ * so nothing of it gets saved on exit.
+ */
+GeoscapeSimulation::~GeoscapeSimulation()
+{
+	delete _geoscape;
+	_game->setSavedGame(0);
+}
+
+/**
+ * Runs one of the geoscape time handlers and adds up the time it took.
+ * @param trigger Time trigger of the handler.
+ * @param func Handler to run.
+ */
+void GeoscapeSimulation::profile(TimeTrigger trigger, void (GeoscapeState::*func)())
+{
+	auto start = std::chrono::steady_clock::now();
+	(_geoscape->*func)();
+	auto end = std::chrono::steady_clock::now();
+	_time[trigger] += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	_calls[trigger]++;
+}
+
+/**
+ * Resolves everything the geoscape left waiting for the player:
+ * popups are dismissed, crafts asking to land go back to base,
+ * interceptions are called off, generated battles are thrown away
+ * and any state pushed on top of the owner (cutscenes, saves,
+ * briefings) is closed without running.
+ */
+void GeoscapeSimulation::resolve()
+{
+	for (State *popup : _geoscape->_popups)
+	{
+		if (ConfirmLandingState *landing = dynamic_cast<ConfirmLandingState*>(popup))
+		{
+			landing->getCraft()->returnToBase();
+		}
+		delete popup;
+		_popups++;
+	}
+	_geoscape->_popups.clear();
+
+	for (DogfightState *dogfight : _geoscape->_dogfightsToBeStarted)
+	{
+		dogfight->getCraft()->setInDogfight(false);
+		dogfight->getCraft()->returnToBase();
+		delete dogfight;
+		_interceptions++;
+	}
+	_geoscape->_dogfightsToBeStarted.clear();
+	_geoscape->_pause = false;
+
+	if (_game->getSavedGame()->getSavedBattle() != 0)
+	{
+		_game->getSavedGame()->setBattleGame(0);
+		_battles++;
+	}
+	while (!_game->isState(_owner))
+	{
+		_game->popState();
+	}
+}
+
+/**
+ * Logs the time spent in each time handler.
+ * @param days Number of days simulated.
+ * @param total Total time of the simulation in nanoseconds.
+ */
+void GeoscapeSimulation::report(int days, long long total) const
+{
+	static const char *names[] = { "time5Seconds", "time10Minutes", "time30Minutes", "time1Hour", "time1Day", "time1Month" };
+
+	Log(LOG_INFO) << "Simulated " << days << " days in " << total / 1000000 << " ms, " << (days > 0 ? total / days / 1000 : 0) << " us per day";
+	for (int i = 0; i <= TIME_1MONTH; ++i)
+	{
+		std::ostringstream ss;
+		ss << std::left << std::setw(14) << names[i] << std::right;
+		ss << " calls " << std::setw(9) << _calls[i];
+		ss << " total " << std::setw(8) << _time[i] / 1000000 << " ms";
+		ss << " avg " << std::setw(8) << (_calls[i] > 0 ? _time[i] / _calls[i] / 1000 : 0) << " us";
+		ss << " share " << std::setw(3) << (total > 0 ? _time[i] * 100 / total : 0) << "%";
+		Log(LOG_INFO) << ss.str();
+	}
+	Log(LOG_INFO) << "Dismissed " << _popups << " popups, called off " << _interceptions << " interceptions, skipped " << _battles << " battles";
+}
+
+/**
+ * Loads a saved game and advances its geoscape by a number of days,
+ * logging the time taken by each day and a profile of the time handlers.
+ * @param filename Name of the save in the user folder.
+ * @param days Number of days to simulate.
+ * @return True if the save was loaded.
+ */
+bool GeoscapeSimulation::run(const std::string &filename, int days)
+{
+	SavedGame *save = new SavedGame();
+	try
+	{
+		save->load(filename, _game->getMod(), _game->getLanguage());
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << "Simulation: " << e.what();
+		delete save;
+		return false;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << "Simulation: " << e.what();
+		delete save;
+		return false;
+	}
+	_game->setSavedGame(save);
+	if (save->getSavedBattle() != 0)
+	{
+		Log(LOG_WARNING) << "Simulation: save is in a battle, skipping it";
+		save->setBattleGame(0);
+	}
+
+	_geoscape = new GeoscapeState;
+	// same as playing on the fastest speed
+	_geoscape->_timeSpeed = _geoscape->_btn1Day;
+
+	Log(LOG_INFO) << "Simulating " << days << " days of " << filename;
+	auto start = std::chrono::steady_clock::now();
+	auto dayStart = start;
+	int day = 0;
+	while (day < days && save->getEnding() == END_NONE)
+	{
+		TimeTrigger trigger = save->getTime()->advance();
+		switch (trigger)
+		{
+		case TIME_1MONTH:
+			profile(TIME_1MONTH, &GeoscapeState::time1Month);
+			FALLTHROUGH;
+		case TIME_1DAY:
+			profile(TIME_1DAY, &GeoscapeState::time1Day);
+			FALLTHROUGH;
+		case TIME_1HOUR:
+			profile(TIME_1HOUR, &GeoscapeState::time1Hour);
+			FALLTHROUGH;
+		case TIME_30MIN:
+			profile(TIME_30MIN, &GeoscapeState::time30Minutes);
+			FALLTHROUGH;
+		case TIME_10MIN:
+			profile(TIME_10MIN, &GeoscapeState::time10Minutes);
+			FALLTHROUGH;
+		case TIME_5SEC:
+			profile(TIME_5SEC, &GeoscapeState::time5Seconds);
+		}
+		resolve();
+
+		if (trigger == TIME_1DAY || trigger == TIME_1MONTH)
+		{
+			auto now = std::chrono::steady_clock::now();
+			std::ostringstream ss;
+			ss << std::setfill('0') << save->getTime()->getYear() << "-" << std::setw(2) << save->getTime()->getMonth() << "-" << std::setw(2) << save->getTime()->getDay();
+			Log(LOG_INFO) << "Day " << day + 1 << " (" << ss.str() << "): " << std::chrono::duration_cast<std::chrono::microseconds>(now - dayStart).count() << " us";
+			dayStart = now;
+			++day;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	if (save->getEnding() != END_NONE)
+	{
+		Log(LOG_INFO) << "Simulation: game ended after " << day << " days";
+	}
+	report(day, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	return true;
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include "../Savegame/GameTime.h"
+
+namespace OpenXcom
+{
+
+class Game;
+class State;
+class GeoscapeState;
+
+/**
+ * Runs the geoscape of a saved game forward at full speed, without
+ * drawing or user input, and logs how long the game logic took.
+ * Anything that would wait for the player is resolved by a fixed
+ * policy: popups are dismissed, landings are declined, interceptions
+ * are called off and generated battles are thrown away.
+ */
+class GeoscapeSimulation
+{
+private:
+	Game *_game;
+	State *_owner;
+	GeoscapeState *_geoscape;
+	long long _time[TIME_1MONTH + 1];
+	int _calls[TIME_1MONTH + 1];
+	int _popups, _interceptions, _battles;
+
+	/// Runs a time handler and adds up the time it took.
+	void profile(TimeTrigger trigger, void (GeoscapeState::*func)());
+	/// Resolves everything that waits for the player.
+	void resolve();
+	/// Logs the time spent in each handler.
+	void report(int days, long long total) const;
+public:
+	/// Creates a simulation on top of a state.
+	GeoscapeSimulation(Game *game, State *owner);
+	/// Cleans up the simulation.
+	~GeoscapeSimulation();
+	/// Loads a saved game and simulates it for a number of days.
+	bool run(const std::string &filename, int days);
+};
+
+}
@@ -713,6 +713,7 @@ void GeoscapeState::init()
 void GeoscapeState::think()
 {
 	State::think();
+	SaveGameState::showBackgroundErrors(OPT_GEOSCAPE, _palette);
 
 	_zoomInEffectTimer->think(this, 0);
 	_zoomOutEffectTimer->think(this, 0);
@@ -1459,6 +1460,20 @@ struct SetRetaliationTarget
 	void operator()(const argument_type &iter) const { iter.second->setRetaliationTarget(true); }
 };
 
+/**
+ * Starts background loading of sprites that will be needed
+ * if player decides to intercept newly detected UFO.
+ * @param ufo Detected UFO.
+ */
+void GeoscapeState::prefetchUfoResources(Ufo *ufo)
+{
+	Mod *mod = _game->getMod();
+	if (!ufo->getRules()->getModSprite().empty())
+	{
+		mod->prefetchSurface(ufo->getRules()->getModSprite());
+	}
+}
+
 /**
  * Takes care of any game logic that has to
  * run every game ten minutes, like fuel consumption.
@@ -1950,6 +1965,7 @@ void GeoscapeState::time30Minutes()
 							ufo->setHyperDetected(true);
 						}
 						ufo->setDetected(true);
+						prefetchUfoResources(ufo);
 						// don't show if player said he doesn't want to see this UFO anymore
 						if (!_game->getSavedGame()->isUfoOnIgnoreList(ufo->getId()))
 						{
@@ -2107,9 +2123,9 @@ void GeoscapeState::time1Hour()
 				_game->getSavedGame()->setAlienContainmentChecked(true);
 				std::map<int, int> prisonTypes;
 				RuleItem *rule = nullptr;
-				for (auto &item : *(*i)->getStorageItems()->getContents())
+				for (auto &item : (*i)->getStorageItems()->getContents())
 				{
-					rule = _game->getMod()->getItem(item.first, true);
+					rule = _game->getMod()->getItemById(item.first, true);
 					if (rule->isAlien())
 					{
 						prisonTypes[rule->getPrisonType()] += 1;
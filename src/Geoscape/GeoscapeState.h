@@ -43,6 +43,7 @@ class RuleMissionScript;
  */
 class GeoscapeState : public State
 {
+	friend class GeoscapeSimulation;
 private:
 	Surface *_bg, *_sideLine, *_sidebar;
 	Globe *_globe;
@@ -184,6 +185,8 @@ private:
 	void determineAlienMissions();
 	/// Process each individual mission script command.
 	bool processCommand(RuleMissionScript *command);
+	/// Starts background loading of sprites needed to intercept UFO.
+	void prefetchUfoResources(Ufo *ufo);
 	bool buttonsDisabled();
 	void updateSlackingIndicator();
 };
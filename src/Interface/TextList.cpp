@@ -63,13 +63,17 @@ TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(wid
  */
 TextList::~TextList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector<Slot>::iterator u = _slots.begin(); u < _slots.end(); ++u)
 	{
-		for (std::vector<Text*>::iterator v = (*u).begin(); v < (*u).end(); ++v)
+		for (std::vector<Text*>::iterator v = u->texts.begin(); v < u->texts.end(); ++v)
 		{
 			delete *v;
 		}
 	}
+	for (std::vector<Text*>::iterator i = _measure.begin(); i < _measure.end(); ++i)
+	{
+		delete *i;
+	}
 	for (std::vector<ArrowButton*>::iterator i = _arrowLeft.begin(); i < _arrowLeft.end(); ++i)
 	{
 		delete *i;
@@ -155,7 +159,8 @@ void TextList::unpress(State *state)
  */
 void TextList::setCellColor(size_t row, size_t column, Uint8 color)
 {
-	_texts[row][column]->setColor(color);
+	_texts[row].cells[column].color = color;
+	_texts[row].version++;
 	_redraw = true;
 }
 
@@ -166,10 +171,11 @@ void TextList::setCellColor(size_t row, size_t column, Uint8 color)
  */
 void TextList::setRowColor(size_t row, Uint8 color)
 {
-	for (std::vector<Text*>::iterator i = _texts[row].begin(); i < _texts[row].end(); ++i)
+	for (std::vector<Cell>::iterator i = _texts[row].cells.begin(); i < _texts[row].cells.end(); ++i)
 	{
-		(*i)->setColor(color);
+		i->color = color;
 	}
+	_texts[row].version++;
 	_redraw = true;
 }
 
@@ -181,7 +187,7 @@ void TextList::setRowColor(size_t row, Uint8 color)
  */
 std::string TextList::getCellText(size_t row, size_t column) const
 {
-	return _texts[row][column]->getText();
+	return _texts[row].cells[column].text;
 }
 
 /**
@@ -192,7 +198,10 @@ std::string TextList::getCellText(size_t row, size_t column) const
  */
 void TextList::setCellText(size_t row, size_t column, const std::string &text)
 {
-	_texts[row][column]->setText(text);
+	Cell &cell = _texts[row].cells[column];
+	cell.text = text;
+	measureCell(cell, getMeasureText(column, cell.width, _texts[row].height));
+	_texts[row].version++;
 	_redraw = true;
 }
 
@@ -203,7 +212,7 @@ void TextList::setCellText(size_t row, size_t column, const std::string &text)
  */
 int TextList::getColumnX(size_t column) const
 {
-	return getX() + _texts[0][column]->getX();
+	return getX() + _texts[0].cells[column].x;
 }
 
 /**
@@ -213,7 +222,7 @@ int TextList::getColumnX(size_t column) const
  */
 int TextList::getRowY(size_t row) const
 {
-	return getY() + _texts[row][0]->getY();
+	return getY() + _texts[row].y;
 }
 
 /**
@@ -223,7 +232,7 @@ int TextList::getRowY(size_t row) const
  */
 int TextList::getTextHeight(size_t row) const
 {
-	return _texts[row].front()->getTextHeight();
+	return _texts[row].cells.front().textHeight;
 }
 
 /**
@@ -233,7 +242,7 @@ int TextList::getTextHeight(size_t row) const
  */
 int TextList::getNumTextLines(size_t row) const
 {
-	return _texts[row].front()->getNumLines();
+	return _texts[row].cells.front().lines;
 }
 
 /**
@@ -273,8 +282,8 @@ size_t TextList::getVisibleRows() const
 }
 
 /**
- * Adds a new row of text to the list, automatically creating
- * the required Text objects lined up where they need to be.
+ * Adds a new row of text to the list, automatically measuring
+ * the cells and lining them up where they need to be.
  * @param cols Number of columns.
  * @param ... Text for each cell in the new row.
  */
@@ -292,56 +301,50 @@ void TextList::addRow(int cols, ...)
 		ncols = 1;
 	}
 
-	std::vector<Text*> temp;
+	Row row;
+	row.version = 0;
 	// Positions are relative to list surface.
 	int rowX = 0, rowY = 0, rows = 1, rowHeight = 0;
 	if (!_texts.empty())
 	{
-		rowY = _texts.back().front()->getY() + _texts.back().front()->getHeight() + _font->getSpacing();
+		rowY = _texts.back().y + _texts.back().height + _font->getSpacing();
 	}
 
 	for (int i = 0; i < ncols; ++i)
 	{
-		int width;
+		Cell cell;
 		// Place text
 		if (_flooding)
 		{
-			width = 340;
-		}
-		else
-		{
-			width = _columns[i];
-		}
-		Text* txt = new Text(width, _font->getHeight(), _margin + rowX, rowY);
-		txt->setPalette(this->getPalette());
-		txt->initText(_big, _small, _lang);
-		txt->setColor(_color);
-		txt->setSecondaryColor(_color2);
-		if (_align[i])
-		{
-			txt->setAlign(_align[i]);
-		}
-		txt->setHighContrast(_contrast);
-		if (_font == _big)
-		{
-			txt->setBig();
+			cell.width = 340;
 		}
 		else
 		{
-			txt->setSmall();
+			cell.width = _columns[i];
 		}
+		cell.x = _margin + rowX;
+		cell.color = _color;
+		cell.color2 = _color2;
+		cell.align = _align[i];
+		cell.big = (_font == _big);
+		cell.wrap = false;
+		cell.ignoreSeparators = _ignoreSeparators;
 		if (cols > 0)
-			txt->setText(va_arg(args, char*));
+			cell.text = va_arg(args, char*);
+
+		Text *txt = getMeasureText(i, cell.width, _font->getHeight());
+		measureCell(cell, txt);
 		// grab this before we enable word wrapping so we can use it to calculate
 		// the total row height below
 		int vmargin = _font->getHeight() - txt->getTextHeight();
 		// Wordwrap text if necessary
 		if (_wrap && txt->getTextWidth() > txt->getWidth())
 		{
-			txt->setWordWrap(true, true, _ignoreSeparators);
-			rows = std::max(rows, txt->getNumLines());
+			cell.wrap = true;
+			measureCell(cell, txt);
+			rows = std::max(rows, cell.lines);
 		}
-		rowHeight = std::max(rowHeight, txt->getTextHeight() + vmargin);
+		rowHeight = std::max(rowHeight, cell.textHeight + vmargin);
 
 		// Places dots between text
 		if (_dot && i < cols - 1)
@@ -361,10 +364,10 @@ void TextList::addRow(int cols, ...)
 					buf.insert(0, 1, '.');
 				}
 			}
-			txt->setText(buf);
+			cell.text = buf;
+			measureCell(cell, txt);
 		}
 
-		temp.push_back(txt);
 		if (_condensed)
 		{
 			rowX += txt->getTextWidth();
@@ -373,52 +376,20 @@ void TextList::addRow(int cols, ...)
 		{
 			rowX += _columns[i];
 		}
+		row.cells.push_back(cell);
 	}
 
 	// ensure all elements in this row are the same height
-	for (int i = 0; i < cols; ++i)
-	{
-		temp[i]->setHeight(rowHeight);
-	}
+	row.y = rowY;
+	row.height = cols > 0 ? rowHeight : _font->getHeight();
 
-	_texts.push_back(temp);
+	_texts.push_back(row);
 	for (int i = 0; i < rows; ++i)
 	{
 		_rows.push_back(_texts.size() - 1);
 	}
 
-	// Place arrow buttons
-	// Position defined w.r.t. main window, NOT TextList.
-	if (_arrowPos != -1)
-	{
-		ArrowShape shape1, shape2;
-		if (_arrowType == ARROW_VERTICAL)
-		{
-			shape1 = ARROW_SMALL_UP;
-			shape2 = ARROW_SMALL_DOWN;
-		}
-		else
-		{
-			shape1 = ARROW_SMALL_LEFT;
-			shape2 = ARROW_SMALL_RIGHT;
-		}
-		ArrowButton *a1 = new ArrowButton(shape1, 11, 8, getX() + _arrowPos, getY());
-		a1->setListButton();
-		a1->setPalette(this->getPalette());
-		a1->setColor(_up->getColor());
-		a1->onMouseClick(_leftClick, 0);
-		a1->onMousePress(_leftPress);
-		a1->onMouseRelease(_leftRelease);
-		_arrowLeft.push_back(a1);
-		ArrowButton *a2 = new ArrowButton(shape2, 11, 8, getX() + _arrowPos + 12, getY());
-		a2->setListButton();
-		a2->setPalette(this->getPalette());
-		a2->setColor(_up->getColor());
-		a2->onMouseClick(_rightClick, 0);
-		a2->onMousePress(_rightPress);
-		a2->onMouseRelease(_rightRelease);
-		_arrowRight.push_back(a2);
-	}
+	updateArrowPool();
 
 	_redraw = true;
 	va_end(args);
@@ -442,19 +413,176 @@ void TextList::removeLastRow()
 			_rows.pop_back();
 		}
 	}
-	if (_arrowPos != -1)
+	invalidateSlots();
+	_redraw = true;
+	updateArrows();
+}
+
+/**
+ * Gets text object used to measure cells of given column,
+ * recreating it if the column size changed.
+ * @param column Column number.
+ * @param width Width of the column.
+ * @param height Height of the row.
+ * @return Text object ready to measure the cell.
+ */
+Text *TextList::getMeasureText(size_t column, int width, int height)
+{
+	if (_measure.size() <= column)
+	{
+		_measure.resize(column + 1, nullptr);
+	}
+	Text *&txt = _measure[column];
+	if (txt == nullptr || txt->getWidth() != width || txt->getHeight() != height)
+	{
+		delete txt;
+		txt = new Text(width, height);
+		txt->initText(_big, _small, _lang);
+	}
+	return txt;
+}
+
+/**
+ * Measures the cell text the same way a Text object would lay it out,
+ * big text that does not fit falls back to small font.
+ * @param cell Cell to measure, gets updated font and size.
+ * @param txt Text object used for measuring.
+ */
+void TextList::measureCell(Cell &cell, Text *txt)
+{
+	if (cell.big)
+	{
+		txt->setBig();
+	}
+	else
+	{
+		txt->setSmall();
+	}
+	txt->setWordWrap(cell.wrap, true, cell.ignoreSeparators);
+	txt->setText(cell.text);
+	cell.big = (txt->getFont() == _big);
+	cell.lines = txt->getNumLines();
+	cell.textHeight = txt->getTextHeight();
+}
+
+/**
+ * Prepares text objects of slot to draw given row.
+ * Nothing is done if the slot already shows current content of the row.
+ * @param slot Slot number.
+ * @param row Row number.
+ * @return Slot ready to blit.
+ */
+TextList::Slot &TextList::updateSlot(size_t slot, size_t row)
+{
+	if (_slots.size() <= slot)
 	{
-		if (!_arrowLeft.empty())
+		_slots.resize(slot + 1, Slot{ {}, (size_t)-1, 0 });
+	}
+	Slot &s = _slots[slot];
+	const Row &r = _texts[row];
+	if (s.row == row && s.version == r.version)
+	{
+		return s;
+	}
+
+	while (s.texts.size() > r.cells.size())
+	{
+		delete s.texts.back();
+		s.texts.pop_back();
+	}
+	while (s.texts.size() < r.cells.size())
+	{
+		Text *txt = new Text(r.cells[s.texts.size()].width, r.height);
+		txt->setPalette(getPalette());
+		txt->initText(_big, _small, _lang);
+		s.texts.push_back(txt);
+	}
+	for (size_t i = 0; i < r.cells.size(); ++i)
+	{
+		const Cell &cell = r.cells[i];
+		Text *txt = s.texts[i];
+		if (txt->getWidth() != cell.width)
 		{
-			_arrowLeft.pop_back();
+			txt->setWidth(cell.width);
 		}
-		if (!_arrowRight.empty())
+		if (txt->getHeight() != r.height)
 		{
-			_arrowRight.pop_back();
+			txt->setHeight(r.height);
 		}
+		txt->setX(cell.x);
+		txt->setColor(cell.color);
+		txt->setSecondaryColor(cell.color2);
+		txt->setAlign(cell.align);
+		txt->setHighContrast(_contrast);
+		if (cell.big)
+		{
+			txt->setBig();
+		}
+		else
+		{
+			txt->setSmall();
+		}
+		txt->setWordWrap(cell.wrap, true, cell.ignoreSeparators);
+		txt->setText(cell.text);
+	}
+	s.row = row;
+	s.version = r.version;
+	return s;
+}
+
+/**
+ * Forgets rows drawn by slots, so they get refreshed on next draw.
+ */
+void TextList::invalidateSlots()
+{
+	for (std::vector<Slot>::iterator i = _slots.begin(); i < _slots.end(); ++i)
+	{
+		i->row = -1;
+	}
+}
+
+/**
+ * Creates arrow buttons for all visible rows.
+ * Buttons are reused when list scrolls, they are not bound to specific rows.
+ */
+void TextList::updateArrowPool()
+{
+	if (_arrowPos == -1)
+	{
+		return;
+	}
+	// Position defined w.r.t. main window, NOT TextList.
+	ArrowShape shape1, shape2;
+	if (_arrowType == ARROW_VERTICAL)
+	{
+		shape1 = ARROW_SMALL_UP;
+		shape2 = ARROW_SMALL_DOWN;
+	}
+	else
+	{
+		shape1 = ARROW_SMALL_LEFT;
+		shape2 = ARROW_SMALL_RIGHT;
+	}
+	const size_t needed = std::min(_texts.size(), _visibleRows);
+	while (_arrowLeft.size() < needed)
+	{
+		ArrowButton *a1 = new ArrowButton(shape1, 11, 8, getX() + _arrowPos, getY());
+		a1->setListButton();
+		a1->setPalette(this->getPalette());
+		a1->setColor(_up->getColor());
+		a1->onMouseClick(_leftClick, 0);
+		a1->onMousePress(_leftPress);
+		a1->onMouseRelease(_leftRelease);
+		_arrowLeft.push_back(a1);
+		ArrowButton *a2 = new ArrowButton(shape2, 11, 8, getX() + _arrowPos + 12, getY());
+		a2->setListButton();
+		a2->setPalette(this->getPalette());
+		a2->setColor(_up->getColor());
+		a2->onMouseClick(_rightClick, 0);
+		a2->onMousePress(_rightPress);
+		a2->onMouseRelease(_rightRelease);
+		_arrowRight.push_back(a2);
 	}
-	_redraw = true;
-	updateArrows();
 }
 
 /**
@@ -488,9 +616,9 @@ void TextList::setColumns(int cols, ...)
 void TextList::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector<Slot>::iterator u = _slots.begin(); u < _slots.end(); ++u)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		for (std::vector<Text*>::iterator v = u->texts.begin(); v < u->texts.end(); ++v)
 		{
 			(*v)->setPalette(colors, firstcolor, ncolors);
 		}
@@ -559,12 +687,13 @@ void TextList::setColor(Uint8 color)
 	_up->setColor(color);
 	_down->setColor(color);
 	_scrollbar->setColor(color);
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector<Row>::iterator u = _texts.begin(); u < _texts.end(); ++u)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		for (std::vector<Cell>::iterator v = u->cells.begin(); v < u->cells.end(); ++v)
 		{
-			(*v)->setColor(color);
+			v->color = color;
 		}
+		u->version++;
 	}
 }
 
@@ -614,9 +743,9 @@ void TextList::setWordWrap(bool wrap)
 void TextList::setHighContrast(bool contrast)
 {
 	_contrast = contrast;
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector<Slot>::iterator u = _slots.begin(); u < _slots.end(); ++u)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		for (std::vector<Text*>::iterator v = u->texts.begin(); v < u->texts.end(); ++v)
 		{
 			(*v)->setHighContrast(contrast);
 		}
@@ -883,17 +1012,10 @@ void TextList::onRightArrowRelease(ActionHandler handler)
  */
 void TextList::clearList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
-	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			delete (*v);
-		}
-		u->clear();
-	}
 	scrollUp(true, false);
 	_texts.clear();
 	_rows.clear();
+	invalidateSlots();
 	_redraw = true;
 }
 
@@ -979,6 +1101,7 @@ void TextList::updateVisible()
 	{
 		_visibleRows++;
 	}
+	updateArrowPool();
 	updateArrows();
 }
 
@@ -1014,21 +1137,18 @@ void TextList::draw()
 		{
 			y -= _font->getHeight() + _font->getSpacing();
 		}
-		for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows; ++i)
+		const size_t first = _rows[_scroll];
+		for (size_t i = first; i < _texts.size() && i < first + _visibleRows; ++i)
 		{
-			for (std::vector<Text*>::iterator j = _texts[i].begin(); j < _texts[i].end(); ++j)
+			// slots are picked by row number, so scrolling by one row only refreshes one slot
+			Slot &slot = updateSlot(i % _visibleRows, i);
+			_texts[i].y = y;
+			for (std::vector<Text*>::iterator j = slot.texts.begin(); j < slot.texts.end(); ++j)
 			{
 				(*j)->setY(y);
 				(*j)->blit(this->getSurface());
 			}
-			if (!_texts[i].empty())
-			{
-				y += _texts[i].front()->getHeight() + _font->getSpacing();
-			}
-			else
-			{
-				y += _font->getHeight() + _font->getSpacing();
-			}
+			y += _texts[i].height + _font->getSpacing();
 		}
 	}
 }
@@ -1054,26 +1174,20 @@ void TextList::blit(SDL_Surface *surface)
 				y -= _font->getHeight() + _font->getSpacing();
 			}
 			int maxY = getY() + getHeight();
-			for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows && y < maxY; ++i)
+			const size_t first = _rows[_scroll];
+			for (size_t i = first; i < _texts.size() && i - first < _arrowLeft.size() && y < maxY; ++i)
 			{
-				_arrowLeft[i]->setY(y);
-				_arrowRight[i]->setY(y);
+				_arrowLeft[i - first]->setY(y);
+				_arrowRight[i - first]->setY(y);
 
 				if (y >= getY())
 				{
 					// only blit arrows that belong to texts that have their first row on-screen
-					_arrowLeft[i]->blit(surface);
-					_arrowRight[i]->blit(surface);
+					_arrowLeft[i - first]->blit(surface);
+					_arrowRight[i - first]->blit(surface);
 				}
 
-				if (!_texts[i].empty())
-				{
-					y += _texts[i].front()->getHeight() + _font->getSpacing();
-				}
-				else
-				{
-					y += _font->getHeight() + _font->getSpacing();
-				}
+				y += _texts[i].height + _font->getSpacing();
 			}
 		}
 		_up->blit(surface);
@@ -1110,10 +1224,10 @@ void TextList::handle(Action *action, State *state)
 				++endArrowIdx;
 			}
 		}
-		for (size_t i = startArrowIdx; i < endArrowIdx; ++i)
+		for (size_t i = startArrowIdx; i < endArrowIdx && i - _rows[_scroll] < _arrowLeft.size(); ++i)
 		{
-			_arrowLeft[i]->handle(action, state);
-			_arrowRight[i]->handle(action, state);
+			_arrowLeft[i - _rows[_scroll]]->handle(action, state);
+			_arrowRight[i - _rows[_scroll]]->handle(action, state);
 		}
 	}
 }
@@ -1229,9 +1343,9 @@ void TextList::mouseOver(Action *action, State *state)
 		_selRow = std::max(0, (int)(_scroll + (int)floor(action->getRelativeYMouse() / (rowHeight * action->getYScale()))));
 		if (_selRow < _rows.size())
 		{
-			Text *selText = _texts[_rows[_selRow]].front();
-			int y = getY() + selText->getY();
-			int actualHeight = selText->getHeight() + _font->getSpacing(); //current line height
+			const Row &selText = _texts[_rows[_selRow]];
+			int y = getY() + selText.y;
+			int actualHeight = selText.height + _font->getSpacing(); //current line height
 			if (y < getY() || y + actualHeight > getY() + getHeight())
 			{
 				actualHeight /= 2;
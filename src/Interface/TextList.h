@@ -35,12 +35,40 @@ class ScrollBar;
  * List of Text's split into columns.
  * Contains a set of Text's that are automatically lined up by
  * rows and columns, like a big table, making it easy to manage
- * them together.
+ * them together. Rows are stored as plain data, only the visible
+ * ones are drawn using a small pool of reused Text's.
  */
 class TextList : public InteractiveSurface
 {
 private:
-	std::vector< std::vector<Text*> > _texts;
+	/// Content of one cell, stored as plain data.
+	struct Cell
+	{
+		std::string text;
+		int x, width;
+		Uint8 color, color2;
+		TextHAlign align;
+		bool big, wrap, ignoreSeparators;
+		int lines, textHeight;
+	};
+	/// One row of cells, can span multiple lines when wrapped.
+	struct Row
+	{
+		std::vector<Cell> cells;
+		int y, height;
+		unsigned version;
+	};
+	/// Text objects used to draw one visible row.
+	struct Slot
+	{
+		std::vector<Text*> texts;
+		size_t row;
+		unsigned version;
+	};
+
+	std::vector<Row> _texts;
+	std::vector<Slot> _slots;
+	std::vector<Text*> _measure;
 	std::vector<size_t> _columns, _rows;
 	Font *_big, *_small, *_font;
 	Language *_lang;
@@ -65,6 +93,16 @@ private:
 	void updateArrows();
 	/// Updates the visible rows.
 	void updateVisible();
+	/// Creates arrow buttons for all visible rows.
+	void updateArrowPool();
+	/// Gets text object used to measure cells of given column.
+	Text *getMeasureText(size_t column, int width, int height);
+	/// Measures cell text and updates font and size of cell.
+	void measureCell(Cell &cell, Text *txt);
+	/// Prepares text objects of slot to draw given row.
+	Slot &updateSlot(size_t slot, size_t row);
+	/// Forgets rows drawn by slots.
+	void invalidateSlots();
 public:
 	/// Creates a text list with the specified size and position.
 	TextList(int width, int height, int x = 0, int y = 0);
@@ -30,11 +30,13 @@
 #include "NewGameState.h"
 #include "NewBattleState.h"
 #include "ListLoadState.h"
+#include "LoadGameState.h"
 #include "OptionsVideoState.h"
 #include "OptionsModsState.h"
 #include "../Engine/Options.h"
 #include "../Engine/FileMap.h"
 #include "../Engine/SDL2Helpers.h"
+#include "../Battlescape/BattleRecording.h"
 #include <fstream>
 
 namespace OpenXcom
@@ -204,6 +206,22 @@ void MainMenuState::init()
 		Log(LOG_INFO) << "Loading last saved game";
 		btnLoadClick(NULL);
 	}
+	else if (!Options::getReplayBattle().empty())
+	{
+		// make it so that this fires only once
+		BattleRecording *replay = new BattleRecording(Options::getReplayBattle(), true);
+		Options::expendReplayBattle();
+		if (replay->load())
+		{
+			Log(LOG_INFO) << "Replaying recorded battle";
+			BattleRecording::setPendingReplay(replay);
+			_game->pushState(new LoadGameState(OPT_MENU, replay->getSaveName(), _palette));
+		}
+		else
+		{
+			delete replay;
+		}
+	}
 }
 
 /**
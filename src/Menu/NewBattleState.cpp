@@ -301,7 +301,7 @@ void NewBattleState::load(const std::string &filename)
 				}
 
 				// Generate items
-				base->getStorageItems()->getContents()->clear();
+				base->getStorageItems()->clear();
 				const std::vector<std::string> &items = mod->getItemsList();
 				for (std::vector<std::string>::const_iterator i = items.begin(); i != items.end(); ++i)
 				{
@@ -322,12 +322,14 @@ void NewBattleState::load(const std::string &filename)
 				else
 				{
 					_craft = base->getCrafts()->front();
-					for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
+					for (std::map<int, int>::const_iterator i = _craft->getItems()->getContents().begin(); i != _craft->getItems()->getContents().end();)
 					{
-						RuleItem *rule = _game->getMod()->getItem(i->first);
+						RuleItem *rule = _game->getMod()->getItemById(i->first);
+						std::map<int, int>::const_iterator tmp = i;
+						++i;
 						if (!rule)
 						{
-							i->second = 0;
+							_craft->getItems()->removeItem(tmp->first, tmp->second);
 						}
 					}
 				}
@@ -391,7 +393,7 @@ void NewBattleState::initSave()
 	base->getSoldiers()->clear();
 	for (std::vector<Craft*>::iterator i = base->getCrafts()->begin(); i != base->getCrafts()->end(); ++i) delete (*i);
 	base->getCrafts()->clear();
-	base->getStorageItems()->getContents()->clear();
+	base->getStorageItems()->clear();
 
 	_craft = new Craft(mod->getCraft(_crafts[_cbxCraft->getSelected()]), base, 1);
 	base->getCrafts()->push_back(_craft);
@@ -30,6 +30,8 @@
 #include "ErrorMessageState.h"
 #include "MainMenuState.h"
 #include "../Savegame/SavedGame.h"
+#include "../Savegame/SaveWriter.h"
+#include "../Engine/Language.h"
 #include "../Mod/Mod.h"
 #include "../Mod/RuleInterface.h"
 
@@ -158,13 +160,21 @@ void SaveGameState::think()
 		// Save the game
 		try
 		{
-			std::string backup = _filename + ".bak";
-			_game->getSavedGame()->save(backup, _game->getMod());
-			std::string fullPath = Options::getMasterUserFolder() + _filename;
-			std::string bakPath = Options::getMasterUserFolder() + backup;
-			if (!CrossPlatform::moveFile(bakPath, fullPath))
+			YAML::Node brief;
+			std::string data = _game->getSavedGame()->save(_game->getMod(), brief);
+			if (Options::oxceAsyncSave && _type != SAVE_IRONMAN_END)
 			{
-				throw Exception("Save backed up in " + backup);
+				// only the file IO is left for the worker, the game can go on
+				SaveWriter::getShared().push(_filename, std::move(data), brief);
+			}
+			else
+			{
+				SaveWriter::getShared().wait();
+				std::string err = SaveWriter::write(_filename, data, brief);
+				if (!err.empty())
+				{
+					throw Exception(err);
+				}
 			}
 
 			if (_type == SAVE_IRONMAN_END)
@@ -199,14 +209,38 @@ void SaveGameState::think()
  * @param msg Error message.
  */
 void SaveGameState::error(const std::string &msg)
+{
+	error(msg, _origin, _palette);
+}
+
+/**
+ * Pops up a window with an error message.
+ * @param msg Error message.
+ * @param origin Game section the error is shown in.
+ * @param palette Parent state palette.
+ */
+void SaveGameState::error(const std::string &msg, OptionsOrigin origin, SDL_Color *palette)
 {
 	Log(LOG_ERROR) << msg;
 	std::ostringstream error;
-	error << tr("STR_SAVE_UNSUCCESSFUL") << Unicode::TOK_NL_SMALL << msg;
-	if (_origin != OPT_BATTLESCAPE)
-		_game->pushState(new ErrorMessageState(error.str(), _palette, _game->getMod()->getInterface("errorMessages")->getElement("geoscapeColor")->color, "BACK01.SCR", _game->getMod()->getInterface("errorMessages")->getElement("geoscapePalette")->color));
+	error << _game->getLanguage()->getString("STR_SAVE_UNSUCCESSFUL") << Unicode::TOK_NL_SMALL << msg;
+	if (origin != OPT_BATTLESCAPE)
+		_game->pushState(new ErrorMessageState(error.str(), palette, _game->getMod()->getInterface("errorMessages")->getElement("geoscapeColor")->color, "BACK01.SCR", _game->getMod()->getInterface("errorMessages")->getElement("geoscapePalette")->color));
 	else
-		_game->pushState(new ErrorMessageState(error.str(), _palette, _game->getMod()->getInterface("errorMessages")->getElement("battlescapeColor")->color, "TAC00.SCR", _game->getMod()->getInterface("errorMessages")->getElement("battlescapePalette")->color));
+		_game->pushState(new ErrorMessageState(error.str(), palette, _game->getMod()->getInterface("errorMessages")->getElement("battlescapeColor")->color, "TAC00.SCR", _game->getMod()->getInterface("errorMessages")->getElement("battlescapePalette")->color));
+}
+
+/**
+ * Pops up errors of saves that failed in background.
+ * @param origin Game section the errors are shown in.
+ * @param palette Parent state palette.
+ */
+void SaveGameState::showBackgroundErrors(OptionsOrigin origin, SDL_Color *palette)
+{
+	for (const auto &msg : SaveWriter::getShared().takeErrors())
+	{
+		error(msg, origin, palette);
+	}
 }
 
 }
@@ -52,6 +52,10 @@ public:
 	void think() override;
 	/// Shows an error message.
 	void error(const std::string &msg);
+	/// Shows an error message in given game section.
+	static void error(const std::string &msg, OptionsOrigin origin, SDL_Color *palette);
+	/// Shows errors of saves written in background.
+	static void showBackgroundErrors(OptionsOrigin origin, SDL_Color *palette);
 };
 
 }
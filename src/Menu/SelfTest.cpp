@@ -0,0 +1,587 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SelfTest.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/Script.h"
+#include "../Engine/Zoom.h"
+#include "../Mod/Mod.h"
+#include "../Mod/Polygon.h"
+#include "../Mod/RuleGlobe.h"
+#include "../Battlescape/PathfindingNode.h"
+#include "../Battlescape/PathfindingOpenSet.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Gets the time since a point in nanoseconds.
+long long since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Script with one input and one output, run by the script benchmark.
+using SelfTestScript = ScriptParser<ScriptOutputArgs<int&>, int>;
+/// Number of blocks in the script run by the script benchmark.
+const int ScriptBlocks = 50;
+/// Number of runs of each script backend.
+const int ScriptRuns = 20000;
+
+/// Size of the map searched by the open set benchmark.
+const int OpenSetX = 100, OpenSetY = 100, OpenSetZ = 4;
+/// Number of searches timed by the open set benchmark.
+const int OpenSetRuns = 20;
+
+/// Size of the frame scaled by the filter benchmark, same as the default base resolution.
+const int FilterWidth = 320, FilterHeight = 200;
+/// Number of frames scaled by each filter path.
+const int FilterFrames = 100;
+
+/// Number of random points looked up by the globe benchmark.
+const int GlobePoints = 200000;
+/// Largest distance of points placed around polygon corners, in radians.
+const double GlobeJitter = 0.02;
+
+/// Screen filter timed by the filter benchmark.
+struct FilterCase
+{
+	const char *name;
+	bool *option;
+	int factor;
+	int bpp;
+};
+
+/**
+ * Scales the same frame a number of times with the current filter options.
+ * @param src Source frame.
+ * @param dst Scaled frame.
+ * @return Average time of one frame in microseconds.
+ */
+long long scaleFrames(SDL_Surface *src, SDL_Surface *dst)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < FilterFrames; ++i)
+	{
+		Zoom::_zoomSurfaceY(src, dst, 0, 0);
+	}
+	return since(start) / 1000 / FilterFrames;
+}
+
+/**
+ * Gets the frame rate matching a frame time.
+ * @param us Frame time in microseconds.
+ * @return Frames per second.
+ */
+long long getFps(long long us)
+{
+	return us > 0 ? 1000000 / us : 0;
+}
+
+/// Entry of the lazy priority queue the open set used to be.
+struct LazyEntry
+{
+	int cost;
+	int node;
+};
+
+/// Orders lazy entries by least cost.
+struct LazyCompare
+{
+	bool operator()(const LazyEntry *a, const LazyEntry *b) const { return b->cost < a->cost; }
+};
+
+/**
+ * Gets the neighbours of a map cell: the eight around it
+ * on the same level and the ones above and below.
+ * @param index Cell index.
+ * @param result Neighbour indexes.
+ * @return Number of neighbours.
+ */
+int getNeighbours(int index, int *result)
+{
+	const int x = index % OpenSetX, y = (index / OpenSetX) % OpenSetY, z = index / (OpenSetX * OpenSetY);
+	int count = 0;
+	for (int dz = -1; dz <= 1; ++dz)
+	{
+		for (int dy = -1; dy <= 1; ++dy)
+		{
+			for (int dx = -1; dx <= 1; ++dx)
+			{
+				if ((dz != 0 && (dx != 0 || dy != 0)) || (dx == 0 && dy == 0 && dz == 0))
+				{
+					continue;
+				}
+				if (x + dx < 0 || x + dx >= OpenSetX || y + dy < 0 || y + dy >= OpenSetY || z + dz < 0 || z + dz >= OpenSetZ)
+				{
+					continue;
+				}
+				result[count++] = index + dx + dy * OpenSetX + dz * OpenSetX * OpenSetY;
+			}
+		}
+	}
+	return count;
+}
+
+/**
+ * Searches the map with the pathfinding open set.
+ * @param nodes Map nodes.
+ * @param enterCost Cost of entering each cell.
+ * @param cost Resulting cost of reaching each cell.
+ */
+void searchOpenSet(std::vector<PathfindingNode> &nodes, const std::vector<int> &enterCost, std::vector<int> &cost)
+{
+	PathfindingOpenSet openSet;
+	for (auto &node : nodes)
+	{
+		node.reset();
+	}
+	nodes[0].connect(0, 0, 0);
+	openSet.push(&nodes[0]);
+	int neighbours[10];
+	while (!openSet.empty())
+	{
+		PathfindingNode *node = openSet.pop();
+		node->setChecked();
+		const int index = (int)(node - nodes.data());
+		cost[index] = node->getTUCost(false);
+		for (int i = getNeighbours(index, neighbours) - 1; i >= 0; --i)
+		{
+			PathfindingNode *next = &nodes[neighbours[i]];
+			const int nextCost = node->getTUCost(false) + enterCost[neighbours[i]];
+			if (next->isChecked() || (next->inOpenSet() && next->getTUCost(false) <= nextCost))
+			{
+				continue;
+			}
+			next->connect(nextCost, node, 0);
+			openSet.push(next);
+		}
+	}
+}
+
+/**
+ * Searches the map with a lazy priority queue, that leaves
+ * the old entry of a node behind when its cost goes down.
+ * @param nodes Map nodes.
+ * @param enterCost Cost of entering each cell.
+ * @param cost Resulting cost of reaching each cell.
+ */
+void searchLazy(std::vector<PathfindingNode> &nodes, const std::vector<int> &enterCost, std::vector<int> &cost)
+{
+	std::priority_queue<LazyEntry*, std::vector<LazyEntry*>, LazyCompare> queue;
+	std::vector<LazyEntry*> entries(nodes.size(), nullptr);
+	for (auto &node : nodes)
+	{
+		node.reset();
+	}
+	nodes[0].connect(0, 0, 0);
+	entries[0] = new LazyEntry{ 0, 0 };
+	queue.push(entries[0]);
+	int neighbours[10];
+	while (!queue.empty())
+	{
+		LazyEntry *entry = queue.top();
+		queue.pop();
+		const int index = entry->node;
+		delete entry;
+		if (index < 0)
+		{
+			continue;
+		}
+		PathfindingNode *node = &nodes[index];
+		entries[index] = nullptr;
+		node->setChecked();
+		cost[index] = node->getTUCost(false);
+		for (int i = getNeighbours(index, neighbours) - 1; i >= 0; --i)
+		{
+			PathfindingNode *next = &nodes[neighbours[i]];
+			const int nextCost = node->getTUCost(false) + enterCost[neighbours[i]];
+			if (next->isChecked() || (entries[neighbours[i]] && next->getTUCost(false) <= nextCost))
+			{
+				continue;
+			}
+			if (entries[neighbours[i]])
+			{
+				entries[neighbours[i]]->node = -1;
+			}
+			next->connect(nextCost, node, 0);
+			entries[neighbours[i]] = new LazyEntry{ nextCost + next->getTUGuess(), neighbours[i] };
+			queue.push(entries[neighbours[i]]);
+		}
+	}
+}
+
+}
+
+/**
+ * Times full map searches with the pathfinding open set and
+ * with the lazy priority queue it replaced, and checks that
+ * both find the same cost for every cell.
+ * @return True if the costs match.
+ */
+bool SelfTest::openSet()
+{
+	const int size = OpenSetX * OpenSetY * OpenSetZ;
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<int> stepCost(4, 12);
+	std::vector<int> enterCost(size);
+	for (auto &c : enterCost)
+	{
+		c = stepCost(rng);
+	}
+	std::vector<PathfindingNode> nodes;
+	nodes.reserve(size);
+	for (int i = 0; i < size; ++i)
+	{
+		nodes.push_back(PathfindingNode(Position(i % OpenSetX, (i / OpenSetX) % OpenSetY, i / (OpenSetX * OpenSetY))));
+	}
+	std::vector<int> heapCost(size, -1), lazyCost(size, -1);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int run = 0; run < OpenSetRuns; ++run)
+	{
+		searchOpenSet(nodes, enterCost, heapCost);
+	}
+	long long heapTime = since(start);
+	start = std::chrono::steady_clock::now();
+	for (int run = 0; run < OpenSetRuns; ++run)
+	{
+		searchLazy(nodes, enterCost, lazyCost);
+	}
+	long long lazyTime = since(start);
+
+	Log(LOG_INFO) << "Open set: " << OpenSetRuns << " searches of " << size << " nodes, indexed heap " << heapTime / 1000 << " us, lazy queue " << lazyTime / 1000 << " us";
+	for (int i = 0; i < size; ++i)
+	{
+		if (heapCost[i] != lazyCost[i])
+		{
+			Log(LOG_ERROR) << "Open set: node " << i << " costs " << heapCost[i] << " instead of " << lazyCost[i];
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Times the same arithmetic and branching script run by the
+ * switch interpreter and by direct dispatch, and checks that
+ * both return the same value for every input.
+ * @param game Pointer to the core game.
+ * @return True if the results match.
+ */
+bool SelfTest::scripts(Game *game)
+{
+	std::ostringstream code;
+	code << "var int temp;\n";
+	for (int i = 0; i < ScriptBlocks; ++i)
+	{
+		code << "set temp seed;\n";
+		code << "offset temp " << i * 7 + 3 << " " << i + 11 << ";\n";
+		code << "mod temp 1000;\n";
+		code << "if lt temp 500;\n";
+		code << "  add result temp;\n";
+		code << "else;\n";
+		code << "  sub result temp;\n";
+		code << "  bit_xor result " << i << ";\n";
+		code << "end;\n";
+	}
+	code << "return result;\n";
+
+	SelfTestScript parser(game->getMod()->getScriptGlobal(), "selfTest", "result", "seed");
+	SelfTestScript::Container interpreted, direct;
+	const bool directDispatch = Options::oxceScriptDirectDispatch;
+	Options::oxceScriptDirectDispatch = false;
+	interpreted.load("selfTest", code.str(), parser);
+	Options::oxceScriptDirectDispatch = true;
+	direct.load("selfTest", code.str(), parser);
+	Options::oxceScriptDirectDispatch = directDispatch;
+	if (!interpreted || !direct.code())
+	{
+		Log(LOG_ERROR) << "Scripts: the test script did not parse";
+		return false;
+	}
+
+	std::vector<int> interpretedResults(ScriptRuns), directResults(ScriptRuns);
+	auto start = std::chrono::steady_clock::now();
+	for (int seed = 0; seed < ScriptRuns; ++seed)
+	{
+		SelfTestScript::Output arg { 0 };
+		SelfTestScript::Worker work { seed };
+		work.execute(interpreted, arg);
+		interpretedResults[seed] = arg.getFirst();
+	}
+	long long interpretedTime = since(start);
+	start = std::chrono::steady_clock::now();
+	for (int seed = 0; seed < ScriptRuns; ++seed)
+	{
+		SelfTestScript::Output arg { 0 };
+		SelfTestScript::Worker work { seed };
+		work.execute(direct, arg);
+		directResults[seed] = arg.getFirst();
+	}
+	long long directTime = since(start);
+
+	Log(LOG_INFO) << "Scripts: " << ScriptRuns << " runs of " << ScriptBlocks << " script blocks, interpreter " << interpretedTime / 1000 << " us, direct dispatch " << directTime / 1000 << " us";
+	for (int seed = 0; seed < ScriptRuns; ++seed)
+	{
+		if (interpretedResults[seed] != directResults[seed])
+		{
+			Log(LOG_ERROR) << "Scripts: input " << seed << " returns " << directResults[seed] << " instead of " << interpretedResults[seed];
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Times every software screen filter on a noisy frame, once on the
+ * calling thread and once split to bands on the worker pool, and checks
+ * that both give the same pixels. Also times flipping a frame that
+ * did not change, which is skipped by the fast scaler.
+ * @return True if the scaled frames match.
+ */
+bool SelfTest::filters()
+{
+	const FilterCase cases[] =
+	{
+		{ "scale2x", &Options::useScaleFilter, 2, 8 },
+		{ "scale3x", &Options::useScaleFilter, 3, 8 },
+		{ "scale4x", &Options::useScaleFilter, 4, 8 },
+		{ "hq2x", &Options::useHQXFilter, 2, 32 },
+		{ "hq3x", &Options::useHQXFilter, 3, 32 },
+		{ "hq4x", &Options::useHQXFilter, 4, 32 },
+		{ "xbrz2x", &Options::useXBRZFilter, 2, 32 },
+		{ "xbrz3x", &Options::useXBRZFilter, 3, 32 },
+		{ "xbrz4x", &Options::useXBRZFilter, 4, 32 },
+		{ "xbrz5x", &Options::useXBRZFilter, 5, 32 },
+		{ "xbrz6x", &Options::useXBRZFilter, 6, 32 },
+	};
+	const bool useScaleFilter = Options::useScaleFilter, useHQXFilter = Options::useHQXFilter, useXBRZFilter = Options::useXBRZFilter;
+	const bool useOpenGL = Options::useOpenGL, fastScaler = Options::oxceFastScaler;
+	const int displayWidth = Options::displayWidth, displayHeight = Options::displayHeight;
+	const int baseXResolution = Options::baseXResolution, baseYResolution = Options::baseYResolution;
+	Options::useOpenGL = false;
+	Options::baseXResolution = FilterWidth;
+	Options::baseYResolution = FilterHeight;
+
+	std::mt19937 rng(1);
+	bool passed = true;
+	for (const auto &c : cases)
+	{
+		Options::useScaleFilter = false;
+		Options::useHQXFilter = false;
+		Options::useXBRZFilter = false;
+		*c.option = true;
+		Options::displayWidth = FilterWidth * c.factor;
+		Options::displayHeight = FilterHeight * c.factor;
+
+		SDL_Surface *src = SDL_CreateRGBSurface(SDL_SWSURFACE, FilterWidth, FilterHeight, c.bpp, 0, 0, 0, 0);
+		SDL_Surface *single = SDL_CreateRGBSurface(SDL_SWSURFACE, FilterWidth * c.factor, FilterHeight * c.factor, c.bpp, 0, 0, 0, 0);
+		SDL_Surface *banded = SDL_CreateRGBSurface(SDL_SWSURFACE, FilterWidth * c.factor, FilterHeight * c.factor, c.bpp, 0, 0, 0, 0);
+		// short runs of few colors, so the filters find edges to smooth
+		std::uniform_int_distribution<int> color(0, 3), run(1, 8);
+		for (int y = 0; y < FilterHeight; ++y)
+		{
+			Uint8 *row = (Uint8 *)src->pixels + y * src->pitch;
+			for (int x = 0; x < FilterWidth;)
+			{
+				const Uint32 value = color(rng) * (c.bpp == 8 ? 0x10 : 0x404040);
+				for (int i = run(rng); i > 0 && x < FilterWidth; --i, ++x)
+				{
+					if (c.bpp == 8)
+					{
+						row[x] = (Uint8)value;
+					}
+					else
+					{
+						((Uint32 *)row)[x] = value;
+					}
+				}
+			}
+		}
+
+		Options::oxceFastScaler = false;
+		long long singleTime = scaleFrames(src, single);
+		Options::oxceFastScaler = true;
+		long long bandedTime = scaleFrames(src, banded);
+		Zoom::resetLastFrame();
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < FilterFrames; ++i)
+		{
+			Zoom::flipWithZoom(src, banded, 0, 0, 0, 0, nullptr);
+		}
+		long long unchangedTime = since(start) / 1000 / FilterFrames;
+		Zoom::resetLastFrame();
+
+		Log(LOG_INFO) << "Filters: " << c.name << ", " << FilterFrames << " frames of " << FilterWidth << "x" << FilterHeight
+			<< ", single thread " << singleTime << " us (" << getFps(singleTime) << " fps)"
+			<< ", bands " << bandedTime << " us (" << getFps(bandedTime) << " fps)"
+			<< ", unchanged frames " << unchangedTime << " us";
+		const size_t rowSize = (size_t)single->w * single->format->BytesPerPixel;
+		for (int y = 0; y < single->h; ++y)
+		{
+			if (std::memcmp((Uint8 *)single->pixels + y * single->pitch, (Uint8 *)banded->pixels + y * banded->pitch, rowSize) != 0)
+			{
+				Log(LOG_ERROR) << "Filters: " << c.name << " row " << y << " differs between single thread and bands";
+				passed = false;
+				break;
+			}
+		}
+		SDL_FreeSurface(banded);
+		SDL_FreeSurface(single);
+		SDL_FreeSurface(src);
+	}
+
+	Options::useScaleFilter = useScaleFilter;
+	Options::useHQXFilter = useHQXFilter;
+	Options::useXBRZFilter = useXBRZFilter;
+	Options::useOpenGL = useOpenGL;
+	Options::oxceFastScaler = fastScaler;
+	Options::displayWidth = displayWidth;
+	Options::displayHeight = displayHeight;
+	Options::baseXResolution = baseXResolution;
+	Options::baseYResolution = baseYResolution;
+	return passed;
+}
+
+/**
+ * Looks up the polygons of random globe points with the lon/lat index
+ * and by testing every polygon, and checks that both find the same one.
+ * Half of the points are spread over the whole globe, the other half
+ * lie around polygon corners, where the borders between cells matter.
+ * @param game Pointer to the core game.
+ * @return True if the polygons match.
+ */
+bool SelfTest::globe(Game *game)
+{
+	RuleGlobe *globe = game->getMod()->getGlobe();
+	std::vector<const Polygon*> polygons(globe->getPolygons()->begin(), globe->getPolygons()->end());
+	if (polygons.empty())
+	{
+		Log(LOG_ERROR) << "Globe: no polygons loaded";
+		return false;
+	}
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> lonDist(0, 2 * M_PI), sinLatDist(-1, 1), jitter(-GlobeJitter, GlobeJitter);
+	std::uniform_int_distribution<size_t> polygonDist(0, polygons.size() - 1);
+	std::vector<std::pair<double, double>> points(GlobePoints);
+	for (int i = 0; i < GlobePoints; ++i)
+	{
+		if (i % 2 == 0)
+		{
+			points[i] = std::make_pair(lonDist(rng), asin(sinLatDist(rng)));
+		}
+		else
+		{
+			const Polygon *poly = polygons[polygonDist(rng)];
+			if (poly->getPoints() == 0)
+			{
+				points[i] = std::make_pair(lonDist(rng), asin(sinLatDist(rng)));
+				continue;
+			}
+			int corner = std::uniform_int_distribution<int>(0, poly->getPoints() - 1)(rng);
+			double lon = poly->getLongitude(corner) + jitter(rng);
+			double lat = std::max(-M_PI / 2, std::min(M_PI / 2, poly->getLatitude(corner) + jitter(rng)));
+			points[i] = std::make_pair(lon, lat);
+		}
+	}
+
+	const bool globeIndex = Options::oxceGlobeIndex;
+	std::vector<Polygon*> indexed(GlobePoints), scanned(GlobePoints);
+	Options::oxceGlobeIndex = true;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < GlobePoints; ++i)
+	{
+		indexed[i] = globe->getPolygonAt(points[i].first, points[i].second);
+	}
+	long long indexTime = since(start);
+	Options::oxceGlobeIndex = false;
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < GlobePoints; ++i)
+	{
+		scanned[i] = globe->getPolygonAt(points[i].first, points[i].second);
+	}
+	long long scanTime = since(start);
+	Options::oxceGlobeIndex = globeIndex;
+
+	Log(LOG_INFO) << "Globe: " << GlobePoints << " points over " << polygons.size() << " polygons, index " << indexTime / 1000 << " us, all polygons " << scanTime / 1000 << " us";
+	for (int i = 0; i < GlobePoints; ++i)
+	{
+		if (indexed[i] != scanned[i])
+		{
+			Log(LOG_ERROR) << "Globe: point " << points[i].first << " " << points[i].second << " is in a different polygon with the index";
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Runs a self-test by name and logs its outcome.
+ * @param game Pointer to the core game.
+ * @param name Name of the self-test.
+ * @return True if the self-test passed.
+ */
+bool SelfTest::run(Game *game, const std::string &name)
+{
+	bool passed;
+	if (name == "openset")
+	{
+		passed = openSet();
+	}
+	else if (name == "scripts")
+	{
+		passed = scripts(game);
+	}
+	else if (name == "filters")
+	{
+		passed = filters();
+	}
+	else if (name == "globe")
+	{
+		passed = globe(game);
+	}
+	else
+	{
+		Log(LOG_ERROR) << "Self-test: unknown test " << name;
+		return false;
+	}
+	if (passed)
+	{
+		Log(LOG_INFO) << "Self-test: " << name << " passed";
+	}
+	else
+	{
+		Log(LOG_ERROR) << "Self-test: " << name << " failed";
+	}
+	return passed;
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+
+namespace OpenXcom
+{
+
+class Game;
+
+/**
+ * Self-tests and micro-benchmarks of the engine parts that have
+ * a faster path next to a reference one, run with -selftest NAME
+ * after the mods are loaded. Each one logs its timings and
+ * checks that both paths give the same results.
+ */
+class SelfTest
+{
+private:
+	/// Compares the pathfinding open set with a lazy priority queue.
+	static bool openSet();
+	/// Compares direct dispatch of scripts with the interpreter.
+	static bool scripts(Game *game);
+	/// Compares banded screen filters with single thread ones.
+	static bool filters();
+	/// Compares the globe polygon index with testing every polygon.
+	static bool globe(Game *game);
+public:
+	/// Runs a self-test by name.
+	static bool run(Game *game, const std::string &name);
+};
+
+}
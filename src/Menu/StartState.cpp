@@ -35,6 +35,9 @@
 #include "../Interface/Text.h"
 #include "MainMenuState.h"
 #include "CutsceneState.h"
+#include "../Geoscape/GeoscapeSimulation.h"
+#include "../Battlescape/BattlescapeSimulation.h"
+#include "SelfTest.h"
 #include <SDL_mixer.h>
 #include <SDL_thread.h>
 
@@ -161,6 +164,14 @@ void StartState::think()
 	switch (loading)
 	{
 	case LOADING_FAILED:
+		if (Options::getHeadless())
+		{
+			// nobody is watching to press a key
+			_game->setExitCode(EXIT_FAILURE);
+			loading = LOADING_DONE;
+			_game->quit();
+			break;
+		}
 		CrossPlatform::flashWindow();
 		addLine("");
 		addLine("ERROR: " + error);
@@ -174,6 +185,43 @@ void StartState::think()
 	case LOADING_SUCCESSFUL:
 		CrossPlatform::flashWindow();
 		Log(LOG_INFO) << "OpenXcom started successfully!";
+		if (!Options::getSimulateSave().empty())
+		{
+			GeoscapeSimulation(_game, this).run(Options::getSimulateSave(), Options::getSimulateDays());
+			loading = LOADING_DONE;
+			_game->quit();
+			break;
+		}
+		if (!Options::getSimulateBattle().empty())
+		{
+			if (!BattlescapeSimulation(_game).run(Options::getSimulateBattle(), Options::getSimulateTurns(), Options::getSimulateSeed()))
+			{
+				_game->setExitCode(EXIT_FAILURE);
+			}
+			loading = LOADING_DONE;
+			_game->quit();
+			break;
+		}
+		if (!Options::getSelfTest().empty())
+		{
+			if (!SelfTest::run(_game, Options::getSelfTest()))
+			{
+				_game->setExitCode(EXIT_FAILURE);
+			}
+			loading = LOADING_DONE;
+			_game->quit();
+			break;
+		}
+		if (!Options::getReplayBattle().empty() && !Options::getReplayRender())
+		{
+			if (!BattlescapeSimulation(_game).replay(Options::getReplayBattle()))
+			{
+				_game->setExitCode(EXIT_FAILURE);
+			}
+			loading = LOADING_DONE;
+			_game->quit();
+			break;
+		}
 		_game->setState(new GoToMainMenuState(true));
 		if (_oldMaster != Options::getActiveMaster() && Options::playIntro)
 		{
@@ -22,6 +22,7 @@
 #include "../Engine/Surface.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/FileMap.h"
+#include "../Engine/AsyncLoader.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Exception.h"
 #include "../Engine/Unicode.h"
@@ -282,6 +283,35 @@ SurfaceSet *ExtraSprites::loadSurfaceSet(SurfaceSet *set)
 	return set;
 }
 
+/**
+ * Queues image files of this sprite for background loading,
+ * so they are ready when the sprite is lazy loaded.
+ */
+void ExtraSprites::prefetch() const
+{
+	if (_loaded)
+		return;
+
+	for (std::map<int, std::string>::const_iterator j = _sprites.begin(); j != _sprites.end(); ++j)
+	{
+		const std::string &fileName = j->second;
+		if (fileName[fileName.length() - 1] == '/')
+		{
+			for (auto f: FileMap::getVFolderContents(fileName))
+			{
+				if (isImageFile(f))
+				{
+					AsyncLoader::getShared().prefetch(fileName + f);
+				}
+			}
+		}
+		else
+		{
+			AsyncLoader::getShared().prefetch(fileName);
+		}
+	}
+}
+
 Surface *ExtraSprites::getFrame(SurfaceSet *set, int index) const
 {
 	int indexWithOffset = index;
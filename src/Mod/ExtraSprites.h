@@ -72,6 +72,8 @@ public:
 	Surface *loadSurface(Surface *surface);
 	/// Load the external sprite into a surface set.
 	SurfaceSet *loadSurfaceSet(SurfaceSet *set);
+	/// Queues image files of this sprite for background loading.
+	void prefetch() const;
 	/// Gets mod data that define this surface.
 	const ModData* getModOwner() { return _current; }
 };
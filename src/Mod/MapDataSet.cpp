@@ -23,6 +23,8 @@
 #include "../Engine/Exception.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/FileMap.h"
+#include "../Engine/AsyncLoader.h"
+#include "../Engine/Options.h"
 #include "../Engine/Logger.h"
 
 namespace OpenXcom
@@ -247,6 +249,19 @@ void MapDataSet::loadData(MCDPatch *patch, bool validate)
 	_surfaceSet->loadPck("TERRAIN/" + _name + ".PCK", "TERRAIN/" + _name + ".TAB");
 }
 
+/**
+ * Queues terrain files for background loading,
+ * so they are already in memory when loadData() needs them.
+ */
+void MapDataSet::prefetchData() const
+{
+	if (_loaded || !Options::oxceAsyncLoader) return;
+
+	AsyncLoader::getShared().prefetch("TERRAIN/" + _name + ".MCD");
+	AsyncLoader::getShared().prefetch("TERRAIN/" + _name + ".PCK");
+	AsyncLoader::getShared().prefetch("TERRAIN/" + _name + ".TAB");
+}
+
 /**
  * Unloads the terrain data.
  */
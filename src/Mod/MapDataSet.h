@@ -61,6 +61,8 @@ public:
 	SurfaceSet *getSurfaceset() const;
 	/// Loads the objects from an MCD file.
 	void loadData(MCDPatch *patch, bool validate = true);
+	/// Queues terrain files for background loading.
+	void prefetchData() const;
 	///	Unloads to free memory.
 	void unloadData();
 	/// Gets a blank floor tile.
@@ -44,6 +44,8 @@
 #include "../Engine/Logger.h"
 #include "../Engine/ScriptBind.h"
 #include "../Engine/Collections.h"
+#include "../Engine/WorkerPool.h"
+#include "../Engine/AsyncLoader.h"
 #include "SoundDefinition.h"
 #include "ExtraSprites.h"
 #include "CustomPalettes.h"
@@ -83,6 +85,7 @@
 #include "RuleEventScript.h"
 #include "RuleEvent.h"
 #include "RuleMissionScript.h"
+#include "RulesetCache.h"
 #include "../Geoscape/Globe.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
@@ -318,6 +321,24 @@ public:
 		_modCurr = i;
 	}
 
+	/// Get offset of mod that currently load scripts.
+	int getProfileMod() const override
+	{
+		return (int)_modCurr;
+	}
+	/// Get name of mod with given offset.
+	std::string getProfileModName(int offset) const override
+	{
+		for (const auto& p : _modNames)
+		{
+			if (offset == p.second)
+			{
+				return p.first;
+			}
+		}
+		return ModNameMaster;
+	}
+
 	/// Get script values
 	ScriptValues<Mod>& getScriptValues() { return _scriptValues; }
 };
@@ -499,7 +520,16 @@ Mod::~Mod()
 	delete _muteSound;
 	delete _globe;
 	delete _converter;
+	if (Options::oxceScriptProfile)
+	{
+		_scriptGlobal->saveProfile(Options::getUserFolder() + "script_profile.csv");
+	}
 	delete _scriptGlobal;
+	if (AsyncLoader *loader = AsyncLoader::findShared())
+	{
+		loader->clear();
+		loader->report();
+	}
 	for (std::map<std::string, Font*>::iterator i = _fonts.begin(); i != _fonts.end(); ++i)
 	{
 		delete i->second;
@@ -742,6 +772,54 @@ T *Mod::getRule(const std::string &id, const std::string &name, const std::map<s
 	}
 }
 
+/**
+ * Gets a specific rule element by ID, using interned registry of rule type when it was already built.
+ * During loading registry is empty and lookup fall back to rule map.
+ * @param id String ID of the rule element.
+ * @param name Human-readable name of the rule type.
+ * @param map Map associated to the rule type.
+ * @param registry Interned registry of the rule type.
+ * @param error Throw an error if not found.
+ * @return Pointer to the rule element, or NULL if not found.
+ */
+template <typename T>
+T *Mod::getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, const RuleRegistry<T> &registry, bool error) const
+{
+	if (!registry.isBuilt())
+	{
+		return getRule(id, name, map, error);
+	}
+	if (id.empty())
+	{
+		return 0;
+	}
+	T *rule = registry.get(RuleRegistry<T>::find(id));
+	if (rule == 0 && error)
+	{
+		throw Exception(name + " " + id + " not found");
+	}
+	return rule;
+}
+
+/**
+ * Builds interned registries of frequently used rule types.
+ * Need to be called after all rules are loaded, any later change of rule maps is not visible in registry.
+ */
+void Mod::buildRuleRegistries()
+{
+	_facilitiesRegistry.build(_facilities);
+	_craftsRegistry.build(_crafts);
+	_craftWeaponsRegistry.build(_craftWeapons);
+	_itemsRegistry.build(_items);
+	_ufosRegistry.build(_ufos);
+	_soldiersRegistry.build(_soldiers);
+	_unitsRegistry.build(_units);
+	_armorsRegistry.build(_armors);
+	_invsRegistry.build(_invs);
+	_researchRegistry.build(_research);
+	_manufactureRegistry.build(_manufacture);
+}
+
 /**
  * Returns a specific font from the mod.
  * @param name Name of the font.
@@ -764,9 +842,43 @@ void Mod::lazyLoadSurface(const std::string &name)
 		std::map<std::string, std::vector<ExtraSprites *> >::const_iterator i = _extraSprites.find(name);
 		if (i != _extraSprites.end())
 		{
+			bool loaded = false;
 			for (std::vector<ExtraSprites*>::const_iterator j = i->second.begin(); j != i->second.end(); ++j)
 			{
-				loadExtraSprite(*j);
+				if (!(*j)->isLoaded())
+				{
+					loadExtraSprite(*j);
+					loaded = true;
+				}
+			}
+			// sets loaded after startup missed the packing in loadAll
+			if (loaded && Options::oxceSurfaceSetAtlas)
+			{
+				auto set = _sets.find(name);
+				if (set != _sets.end())
+				{
+					set->second->pack();
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Starts background loading of a surface or surface set
+ * that is not loaded yet, so later lazy load only need to finish it.
+ * @param name Surface name.
+ */
+void Mod::prefetchSurface(const std::string &name)
+{
+	if (Options::lazyLoadResources && Options::oxceAsyncLoader)
+	{
+		auto i = _extraSprites.find(name);
+		if (i != _extraSprites.end())
+		{
+			for (auto* pack : i->second)
+			{
+				pack->prefetch();
 			}
 		}
 	}
@@ -1677,15 +1789,72 @@ void Mod::loadAll()
 	_soundOffsetBattle = _sounds["BATTLE.CAT"]->getMaxSharedSounds();
 	_soundOffsetGeo = _sounds["GEO.CAT"]->getMaxSharedSounds();
 
+	const std::string cacheFile = Options::getUserFolder() + "ruleset.cache";
+	Uint64 cacheKey = 0;
+	bool cacheValid = false;
+	std::vector<std::vector<std::string>> cacheData;
+	if (Options::oxceRulesetCache)
+	{
+		cacheKey = RulesetCache::getKey(mods);
+		cacheValid = RulesetCache::load(cacheFile, cacheKey, mods, cacheData);
+	}
+	// cache is written only when it was built from scratch in this run
+	const bool cacheSave = Options::oxceRulesetCache && !cacheValid;
+	if (cacheSave)
+	{
+		cacheData.resize(mods.size());
+	}
+
 	Log(LOG_INFO) << "Loading rulesets...";
-	// load rest rulesets
+	Uint32 loadStart = SDL_GetTicks();
+	Uint32 parseTotal = 0;
+	// load rest rulesets, in same order as mods are listed, as later rules override earlier ones
+	// each mod is parsed just before it is applied, so only YAML trees of one mod are kept in memory
 	for (size_t i = 0; mods.size() > i; ++i)
 	{
 		try
 		{
+			Uint32 modStart = SDL_GetTicks();
+			std::vector<ParsedRuleset> parsed;
+			if (cacheValid)
+			{
+				parsed = decodeRulesets(mods[i].second, cacheData[i]);
+				for (const auto& r : parsed)
+				{
+					if (r.error)
+					{
+						cacheValid = false;
+					}
+				}
+				if (!cacheValid)
+				{
+					// earlier mods were already decoded, drop the file so the next run builds it again
+					Log(LOG_WARNING) << "Ruleset cache is corrupted, ignoring it.";
+					CrossPlatform::deleteFile(cacheFile);
+					cacheData.clear();
+				}
+			}
+			if (!cacheValid)
+			{
+				parsed = parseRulesets(mods[i].second, cacheSave);
+			}
+			Uint32 modParseTime = 0;
+			for (const auto& r : parsed)
+			{
+				modParseTime += r.parseTime;
+			}
+			parseTotal += modParseTime;
 			_modCurrent = &_modData.at(i);
 			_scriptGlobal->setMod((int)_modCurrent->offset);
-			loadMod(mods[i].second, parser);
+			loadMod(parsed, parser);
+			if (cacheSave)
+			{
+				for (auto& r : parsed)
+				{
+					cacheData[i].push_back(std::move(r.encoded));
+				}
+			}
+			Log(LOG_INFO) << "- " << mods[i].first << ": parsing " << modParseTime << "ms, loading " << SDL_GetTicks() - modStart << "ms.";
 		}
 		catch (Exception &e)
 		{
@@ -1693,12 +1862,16 @@ void Mod::loadAll()
 			throwModOnErrorHelper(modId, e.what());
 		}
 	}
-	Log(LOG_INFO) << "Loading rulesets done.";
+	Log(LOG_INFO) << "Parsing rulesets took " << parseTotal << "ms of worker time.";
+	Log(LOG_INFO) << "Loading rulesets done in " << SDL_GetTicks() - loadStart << "ms.";
 
 	//back master
 	_modCurrent = &_modData.at(0);
 	_scriptGlobal->endLoad();
 
+	// all mods are loaded, globe polygons will not change anymore
+	_globe->buildPolygonIndex();
+
 	// post-processing item categories
 	std::map<std::string, std::string> replacementRules;
 	for (auto i = _itemCategories.begin(); i != _itemCategories.end(); ++i)
@@ -1829,6 +2002,8 @@ void Mod::loadAll()
 		}
 	}
 
+	buildRuleRegistries();
+
 	// recommended user options
 	if (!_recommendedUserOptions.empty() && !Options::oxceRecommendedOptionsWereSet)
 	{
@@ -1865,31 +2040,139 @@ void Mod::loadAll()
 		Options::save();
 	}
 
+	if (cacheSave)
+	{
+		RulesetCache::save(cacheFile, cacheKey, cacheData);
+	}
+
 	Log(LOG_INFO) << "Loading ended.";
 
 	sortLists();
 	loadExtraResources();
 	modResources();
+
+	if (Options::oxceSurfaceSetAtlas)
+	{
+		for (auto& s : _sets)
+		{
+			s.second->pack();
+		}
+	}
+}
+
+/**
+ * Parses ruleset files of one mod to YAML trees.
+ * Files are opened one by one as zip archives can't be shared between threads,
+ * then text is parsed in parallel, directly from mapped or cached file data. Errors are stored and reported when given file is applied.
+ * @param files Ruleset files of the mod.
+ * @param encode Store encoded form of each file for ruleset cache.
+ * @return Parsed rulesets, in same order as input.
+ */
+std::vector<Mod::ParsedRuleset> Mod::parseRulesets(const std::vector<FileMap::FileRecord> &files, bool encode) const
+{
+	std::vector<ParsedRuleset> parsed(files.size());
+	std::vector<std::unique_ptr<std::istream>> sources(files.size());
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		ParsedRuleset &r = parsed[i];
+		r.file = &files[i];
+		try
+		{
+			sources[i] = r.file->getIStream();
+		}
+		catch (...)
+		{
+			r.error = std::current_exception();
+		}
+	}
+
+	WorkerPool::getShared().parallelFor((int)parsed.size(),
+		[&](int i)
+		{
+			ParsedRuleset &r = parsed[i];
+			if (r.error)
+			{
+				return;
+			}
+			Uint32 start = SDL_GetTicks();
+			try
+			{
+				r.doc = YAML::Load(*sources[i]);
+				if (encode)
+				{
+					r.encoded = RulesetCache::encode(r.doc);
+				}
+			}
+			catch (...)
+			{
+				r.error = std::current_exception();
+			}
+			r.parseTime = SDL_GetTicks() - start;
+			sources[i].reset();
+		}
+	);
+	return parsed;
+}
+
+/**
+ * Decodes ruleset files of one mod from data stored in ruleset cache.
+ * @param files Ruleset files of the mod.
+ * @param cached Encoded files of the mod, released after decoding.
+ * @return Parsed rulesets, in same order as input.
+ */
+std::vector<Mod::ParsedRuleset> Mod::decodeRulesets(const std::vector<FileMap::FileRecord> &files, std::vector<std::string> &cached) const
+{
+	std::vector<ParsedRuleset> parsed(files.size());
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		parsed[i].file = &files[i];
+	}
+
+	WorkerPool::getShared().parallelFor((int)parsed.size(),
+		[&](int i)
+		{
+			ParsedRuleset &r = parsed[i];
+			Uint32 start = SDL_GetTicks();
+			try
+			{
+				r.doc = RulesetCache::decode(cached[i]);
+			}
+			catch (...)
+			{
+				r.error = std::current_exception();
+			}
+			r.parseTime = SDL_GetTicks() - start;
+			std::string().swap(cached[i]);
+		}
+	);
+	return parsed;
 }
 
 /**
  * Loads a list of rulesets from YAML files for the mod at the specified index. The first
  * mod loaded should be the master at index 0, then 1, and so on.
- * @param rulesetFiles List of rulesets to load.
+ * @param rulesets List of parsed rulesets to load, their trees are released once applied.
  * @param parsers Object with all available parsers.
  */
-void Mod::loadMod(const std::vector<FileMap::FileRecord> &rulesetFiles, ModScript &parsers)
+void Mod::loadMod(std::vector<ParsedRuleset> &rulesets, ModScript &parsers)
 {
-	for (auto i = rulesetFiles.begin(); i != rulesetFiles.end(); ++i)
+	for (auto i = rulesets.begin(); i != rulesets.end(); ++i)
 	{
-		Log(LOG_VERBOSE) << "- " << i->fullpath;
+		Log(LOG_VERBOSE) << "- " << i->file->fullpath;
 		try
 		{
-			loadFile(*i, parsers);
+			if (i->error)
+			{
+				Log(LOG_FATAL) << "Error loading file '" << i->file->fullpath << "'";
+				std::rethrow_exception(i->error);
+			}
+			loadFile(i->doc, parsers);
+			// tree is not needed anymore, free it before next file is applied
+			i->doc = YAML::Node();
 		}
 		catch (YAML::Exception &e)
 		{
-			throw Exception(i->fullpath + ": " + std::string(e.what()));
+			throw Exception(i->file->fullpath + ": " + std::string(e.what()));
 		}
 	}
 
@@ -2043,12 +2326,11 @@ void Mod::loadConstants(const YAML::Node &node)
 /**
  * Loads a ruleset's contents from a YAML file.
  * Rules that match pre-existing rules overwrite them.
- * @param filename YAML filename.
+ * @param doc Parsed YAML file.
  * @param parsers Object with all available parsers.
  */
-void Mod::loadFile(const FileMap::FileRecord &filerec, ModScript &parsers)
+void Mod::loadFile(YAML::Node doc, ModScript &parsers)
 {
-	auto doc = filerec.getYAML();
 
 	if (const YAML::Node &extended = doc["extended"])
 	{
@@ -3076,7 +3358,7 @@ const std::vector<std::string> &Mod::getRegionsList() const
  */
 RuleBaseFacility *Mod::getBaseFacility(const std::string &id, bool error) const
 {
-	return getRule(id, "Facility", _facilities, error);
+	return getRule(id, "Facility", _facilities, _facilitiesRegistry, error);
 }
 
 /**
@@ -3096,7 +3378,7 @@ const std::vector<std::string> &Mod::getBaseFacilitiesList() const
  */
 RuleCraft *Mod::getCraft(const std::string &id, bool error) const
 {
-	return getRule(id, "Craft", _crafts, error);
+	return getRule(id, "Craft", _crafts, _craftsRegistry, error);
 }
 
 /**
@@ -3116,7 +3398,7 @@ const std::vector<std::string> &Mod::getCraftsList() const
  */
 RuleCraftWeapon *Mod::getCraftWeapon(const std::string &id, bool error) const
 {
-	return getRule(id, "Craft Weapon", _craftWeapons, error);
+	return getRule(id, "Craft Weapon", _craftWeapons, _craftWeaponsRegistry, error);
 }
 
 /**
@@ -3168,7 +3450,23 @@ RuleItem *Mod::getItem(const std::string &id, bool error) const
 	{
 		return 0;
 	}
-	return getRule(id, "Item", _items, error);
+	return getRule(id, "Item", _items, _itemsRegistry, error);
+}
+
+/**
+ * Returns the rules for the specified item.
+ * @param id Interned item id, see ItemContainer.
+ * @param error Throw an error if not found.
+ * @return Rules for the item, or 0 when the item is not found.
+ */
+RuleItem *Mod::getItemById(int id, bool error) const
+{
+	RuleItem *rule = _itemsRegistry.get(id);
+	if (rule == 0 && error)
+	{
+		throw Exception("Item " + RuleRegistry<RuleItem>::getName(id) + " not found");
+	}
+	return rule;
 }
 
 /**
@@ -3188,7 +3486,7 @@ const std::vector<std::string> &Mod::getItemsList() const
  */
 RuleUfo *Mod::getUfo(const std::string &id, bool error) const
 {
-	return getRule(id, "UFO", _ufos, error);
+	return getRule(id, "UFO", _ufos, _ufosRegistry, error);
 }
 
 /**
@@ -3258,7 +3556,7 @@ RuleSkill *Mod::getSkill(const std::string &name, bool error) const
  */
 RuleSoldier *Mod::getSoldier(const std::string &name, bool error) const
 {
-	return getRule(name, "Soldier", _soldiers, error);
+	return getRule(name, "Soldier", _soldiers, _soldiersRegistry, error);
 }
 
 /**
@@ -3297,7 +3595,7 @@ const std::map<std::string, RuleCommendations *> &Mod::getCommendationsList() co
  */
 Unit *Mod::getUnit(const std::string &name, bool error) const
 {
-	return getRule(name, "Unit", _units, error);
+	return getRule(name, "Unit", _units, _unitsRegistry, error);
 }
 
 /**
@@ -3390,7 +3688,7 @@ const std::vector<std::string> &Mod::getDeploymentsList() const
  */
 Armor *Mod::getArmor(const std::string &name, bool error) const
 {
-	return getRule(name, "Armor", _armors, error);
+	return getRule(name, "Armor", _armors, _armorsRegistry, error);
 }
 
 /**
@@ -3521,7 +3819,7 @@ std::map<std::string, RuleInventory*> *Mod::getInventories()
  */
 RuleInventory *Mod::getInventory(const std::string &id, bool error) const
 {
-	return getRule(id, "Inventory", _invs, error);
+	return getRule(id, "Inventory", _invs, _invsRegistry, error);
 }
 
 /**
@@ -3550,7 +3848,7 @@ const std::vector<std::string> &Mod::getInvsList() const
  */
 RuleResearch *Mod::getResearch(const std::string &id, bool error) const
 {
-	return getRule(id, "Research", _research, error);
+	return getRule(id, "Research", _research, _researchRegistry, error);
 }
 
 /**
@@ -3599,7 +3897,7 @@ const std::vector<std::string> &Mod::getResearchList() const
  */
 RuleManufacture *Mod::getManufacture (const std::string &id, bool error) const
 {
-	return getRule(id, "Manufacture", _manufacture, error);
+	return getRule(id, "Manufacture", _manufacture, _manufactureRegistry, error);
 }
 
 /**
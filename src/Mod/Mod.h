@@ -22,6 +22,7 @@
 #include <string>
 #include <bitset>
 #include <type_traits>
+#include <exception>
 #include <SDL.h>
 #include <yaml-cpp/yaml.h>
 #include "../Engine/Options.h"
@@ -32,6 +33,7 @@
 #include "RuleAlienMission.h"
 #include "RuleBaseFacilityFunctions.h"
 #include "RuleItem.h"
+#include "RuleRegistry.h"
 
 namespace OpenXcom
 {
@@ -197,6 +199,18 @@ private:
 	std::vector<RuleDamageType*> _damageTypes;
 	std::map<std::string, RuleMusic *> _musicDefs;
 
+	RuleRegistry<RuleBaseFacility> _facilitiesRegistry;
+	RuleRegistry<RuleCraft> _craftsRegistry;
+	RuleRegistry<RuleCraftWeapon> _craftWeaponsRegistry;
+	RuleRegistry<RuleItem> _itemsRegistry;
+	RuleRegistry<RuleUfo> _ufosRegistry;
+	RuleRegistry<RuleSoldier> _soldiersRegistry;
+	RuleRegistry<Unit> _unitsRegistry;
+	RuleRegistry<Armor> _armorsRegistry;
+	RuleRegistry<RuleInventory> _invsRegistry;
+	RuleRegistry<RuleResearch> _researchRegistry;
+	RuleRegistry<RuleManufacture> _manufactureRegistry;
+
 	RuleGlobe *_globe;
 	RuleConverter *_converter;
 	ModScriptGlobal *_scriptGlobal;
@@ -299,14 +313,32 @@ private:
 	/// Loads a ruleset from a YAML file that have basic resources configuration.
 	void loadResourceConfigFile(const FileMap::FileRecord &filerec);
 	void loadConstants(const YAML::Node &node);
-	/// Loads a ruleset from a YAML file.
-	void loadFile(const FileMap::FileRecord &filerec, ModScript &parsers);
+	/// Ruleset file parsed ahead of applying it.
+	struct ParsedRuleset
+	{
+		const FileMap::FileRecord *file = nullptr;
+		YAML::Node doc;
+		std::exception_ptr error;
+		Uint32 parseTime = 0;
+		std::string encoded;
+	};
+	/// Parses all ruleset files of one mod in parallel.
+	std::vector<ParsedRuleset> parseRulesets(const std::vector<FileMap::FileRecord> &files, bool encode) const;
+	/// Decodes all ruleset files of one mod from ruleset cache in parallel.
+	std::vector<ParsedRuleset> decodeRulesets(const std::vector<FileMap::FileRecord> &files, std::vector<std::string> &cached) const;
+	/// Loads a ruleset from a parsed YAML file.
+	void loadFile(YAML::Node doc, ModScript &parsers);
 	/// Loads a ruleset element.
 	template <typename T>
 	T *loadRule(const YAML::Node &node, std::map<std::string, T*> *map, std::vector<std::string> *index = 0, const std::string &key = "type") const;
 	/// Gets a ruleset element.
 	template <typename T>
 	T *getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, bool error) const;
+	/// Gets a ruleset element using interned registry when available.
+	template <typename T>
+	T *getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, const RuleRegistry<T> &registry, bool error) const;
+	/// Builds interned registries of frequently used rule types.
+	void buildRuleRegistries();
 	/// Gets a random music. This is private to prevent access, use playMusic(name, true) instead.
 	Music *getRandomMusic(const std::string &name) const;
 	/// Gets a particular sound set. This is private to prevent access, use getSound(name, id) instead.
@@ -318,7 +350,7 @@ private:
 	/// Creates a transparency lookup table for a given palette.
 	void createTransparencyLUT(Palette *pal);
 	/// Loads a specified mod content.
-	void loadMod(const std::vector<FileMap::FileRecord> &rulesetFiles, ModScript &parsers);
+	void loadMod(std::vector<ParsedRuleset> &rulesets, ModScript &parsers);
 	/// Loads resources from vanilla.
 	void loadVanillaResources();
 	/// Loads resources from extra rulesets.
@@ -390,6 +422,8 @@ public:
 
 	/// Gets a particular font.
 	Font *getFont(const std::string &name, bool error = true) const;
+	/// Starts background loading of surface.
+	void prefetchSurface(const std::string &name);
 	/// Gets a particular surface.
 	Surface *getSurface(const std::string &name, bool error = true);
 	/// Gets a particular surface set.
@@ -567,6 +601,10 @@ public:
 	const std::vector<std::string> &getItemCategoriesList() const;
 	/// Gets the ruleset for an item type.
 	RuleItem *getItem(const std::string &id, bool error = false) const;
+	/// Gets the interned id of an item type, or -1 when it was never seen.
+	int getItemId(const std::string &id) const { return RuleRegistry<RuleItem>::find(id); }
+	/// Gets the ruleset for an item by its interned id.
+	RuleItem *getItemById(int id, bool error = false) const;
 	/// Gets the available items.
 	const std::vector<std::string> &getItemsList() const;
 	/// Gets the ruleset for a UFO type.
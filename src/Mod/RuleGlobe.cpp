@@ -25,11 +25,63 @@
 #include "../Engine/Palette.h"
 #include "../Geoscape/Globe.h"
 #include "../Engine/FileMap.h"
+#include "../Engine/Options.h"
 #include "../fmath.h"
+#include <algorithm>
+#include <cmath>
 
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Number of cells of polygon grid along longitude.
+const int GridSizeLon = 180;
+/// Number of cells of polygon grid along latitude.
+const int GridSizeLat = 90;
+/// Safety margin for grid bounds, in radians.
+const double GridMargin = 1e-4;
+
+const double CellLon = 2 * M_PI / GridSizeLon;
+const double CellLat = M_PI / GridSizeLat;
+
+/// Point on unit sphere.
+struct Vec3
+{
+	double x, y, z;
+};
+
+Vec3 toVec(double lon, double lat)
+{
+	return Vec3{ cos(lat) * cos(lon), cos(lat) * sin(lon), sin(lat) };
+}
+
+double angle(const Vec3 &a, const Vec3 &b)
+{
+	return acos(std::max(-1.0, std::min(1.0, a.x * b.x + a.y * b.y + a.z * b.z)));
+}
+
+/**
+ * Gets the grid cell index of a point.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Index of the cell.
+ */
+int getCell(double lon, double lat)
+{
+	lon = fmod(lon, 2 * M_PI);
+	if (lon < 0)
+	{
+		lon += 2 * M_PI;
+	}
+	int x = std::max(0, std::min(GridSizeLon - 1, (int)(lon / CellLon)));
+	int y = std::max(0, std::min(GridSizeLat - 1, (int)((lat + M_PI / 2) / CellLat)));
+	return y * GridSizeLon + x;
+}
+
+}
+
 /**
  * Creates a blank ruleset for globe contents.
  */
@@ -208,6 +260,194 @@ void RuleGlobe::loadDat(const std::string &filename)
 	}
 }
 
+/**
+ * Caches the trigonometry of polygon points and builds a grid
+ * of candidate polygons for each lon/lat cell. A point can only be
+ * inside a polygon if it lies within the cap bounding its points,
+ * so every cell stores the polygons whose cap overlaps the cell.
+ * Must be called after the polygons are loaded.
+ */
+void RuleGlobe::buildPolygonIndex()
+{
+	_polygonPoints.clear();
+	_polygonGrid.clear();
+	for (Polygon *poly : _polygons)
+	{
+		PolygonPoints p;
+		p.polygon = poly;
+		for (int j = 0; j < poly->getPoints(); ++j)
+		{
+			p.lon.push_back(poly->getLongitude(j));
+			p.cosLat.push_back(cos(poly->getLatitude(j)));
+			p.sinLat.push_back(sin(poly->getLatitude(j)));
+		}
+		_polygonPoints.push_back(p);
+	}
+
+	_polygonGrid.resize(GridSizeLon * GridSizeLat);
+	std::vector<Vec3> cellCenter(GridSizeLon * GridSizeLat);
+	std::vector<double> rowSize(GridSizeLat);
+	for (int y = 0; y < GridSizeLat; ++y)
+	{
+		double lat0 = y * CellLat - M_PI / 2;
+		for (int x = 0; x < GridSizeLon; ++x)
+		{
+			cellCenter[y * GridSizeLon + x] = toVec(x * CellLon + CellLon / 2, lat0 + CellLat / 2);
+		}
+		// farthest point of a lon/lat cell from its center is one of its corners
+		rowSize[y] = 0;
+		for (int c = 0; c < 4; ++c)
+		{
+			rowSize[y] = std::max(rowSize[y], angle(cellCenter[y * GridSizeLon], toVec((c & 1) * CellLon, lat0 + (c >> 1) * CellLat)));
+		}
+	}
+	for (int i = 0; i < (int)_polygonPoints.size(); ++i)
+	{
+		const Polygon *poly = _polygonPoints[i].polygon;
+		if (poly->getPoints() == 0)
+		{
+			continue;
+		}
+		Vec3 center = { 0, 0, 0 };
+		for (int j = 0; j < poly->getPoints(); ++j)
+		{
+			Vec3 v = toVec(poly->getLongitude(j), poly->getLatitude(j));
+			center.x += v.x;
+			center.y += v.y;
+			center.z += v.z;
+		}
+		double length = sqrt(center.x * center.x + center.y * center.y + center.z * center.z);
+		double radius = M_PI;
+		if (length > 1e-9)
+		{
+			center.x /= length;
+			center.y /= length;
+			center.z /= length;
+			radius = 0;
+			for (int j = 0; j < poly->getPoints(); ++j)
+			{
+				radius = std::max(radius, angle(center, toVec(poly->getLongitude(j), poly->getLatitude(j))));
+			}
+		}
+		if (radius >= M_PI / 2)
+		{
+			// cap is not convex, polygon can be anywhere
+			for (auto &cell : _polygonGrid)
+			{
+				cell.push_back(i);
+			}
+			continue;
+		}
+
+		double centerLat = asin(std::max(-1.0, std::min(1.0, center.z)));
+		double reach = radius + CellLat + CellLon + GridMargin;
+		int yMin = std::max(0, (int)((centerLat - reach + M_PI / 2) / CellLat));
+		int yMax = std::min(GridSizeLat - 1, (int)((centerLat + reach + M_PI / 2) / CellLat));
+		for (int y = yMin; y <= yMax; ++y)
+		{
+			double limit = cos(std::min(M_PI, radius + rowSize[y] + GridMargin));
+			for (int x = 0; x < GridSizeLon; ++x)
+			{
+				const Vec3 &c = cellCenter[y * GridSizeLon + x];
+				if (center.x * c.x + center.y * c.y + center.z * c.z >= limit)
+				{
+					_polygonGrid[y * GridSizeLon + x].push_back(i);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Returns the first polygon that contains a point.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Pointer to the polygon, or NULL if none.
+ */
+Polygon *RuleGlobe::getPolygonAt(double lon, double lat) const
+{
+	const double zDiscard=0.75f;
+	double coslat = cos(lat);
+	double sinlat = sin(lat);
+
+	auto inside = [&](const PolygonPoints &p)
+	{
+		double x, y, z, x2, y2;
+		int points = (int)p.lon.size();
+		z = 0;
+		for (int j = 0; j < points; ++j)
+		{
+			z = coslat * p.cosLat[j] * cos(p.lon[j] - lon) + sinlat * p.sinLat[j];
+			if (z<zDiscard) return false; //discarded
+		}
+		if (points == 0) return false;
+
+		bool odd = false;
+
+		x = p.cosLat[0] * sin(p.lon[0] - lon); //initial point
+		y = coslat * p.sinLat[0] - sinlat * p.cosLat[0] * cos(p.lon[0] - lon);
+
+		for (int j = 0; j < points; ++j)
+		{
+			int k = (j + 1) % points; //index of next point in poly
+			x2 = p.cosLat[k] * sin(p.lon[k] - lon);
+			y2 = coslat * p.sinLat[k] - sinlat * p.cosLat[k] * cos(p.lon[k] - lon);
+			if ( ((y>0)!=(y2>0)) && (0 < (x2-x)*(0-y)/(y2-y)+x) )
+				odd = !odd;
+			x = x2;
+			y = y2;
+		}
+		return odd;
+	};
+
+	if (Options::oxceGlobeIndex && !_polygonGrid.empty() && lat >= -M_PI / 2 && lat <= M_PI / 2)
+	{
+		for (int i : _polygonGrid[getCell(lon, lat)])
+		{
+			if (inside(_polygonPoints[i])) return _polygonPoints[i].polygon;
+		}
+		return NULL;
+	}
+
+	// index is disabled or not built yet, test every polygon
+	for (std::list<Polygon*>::const_iterator i = _polygons.begin(); i != _polygons.end(); ++i)
+	{
+		double x, y, z, x2, y2;
+		double clat, clon;
+		z = 0;
+		for (int j = 0; j < (*i)->getPoints(); ++j)
+		{
+			z = coslat * cos((*i)->getLatitude(j)) * cos((*i)->getLongitude(j) - lon) + sinlat * sin((*i)->getLatitude(j));
+			if (z<zDiscard) break; //discarded
+		}
+		if (z<zDiscard) continue; //discarded
+
+		bool odd = false;
+
+		clat = (*i)->getLatitude(0); //initial point
+		clon = (*i)->getLongitude(0);
+		x = cos(clat) * sin(clon - lon);
+		y = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
+
+		for (int j = 0; j < (*i)->getPoints(); ++j)
+		{
+			int k = (j + 1) % (*i)->getPoints(); //index of next point in poly
+			clat = (*i)->getLatitude(k);
+			clon = (*i)->getLongitude(k);
+
+			x2 = cos(clat) * sin(clon - lon);
+			y2 = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
+			if ( ((y>0)!=(y2>0)) && (0 < (x2-x)*(0-y)/(y2-y)+x) )
+				odd = !odd;
+			x = x2;
+			y = y2;
+
+		}
+		if (odd) return *i;
+	}
+	return NULL;
+}
+
 /**
  * Returns the rules for the specified texture.
  * @param id Texture ID.
@@ -18,7 +18,9 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <list>
+#include <map>
 #include <string>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -39,6 +41,15 @@ private:
 	std::list<Polygon*> _polygons;
 	std::list<Polyline*> _polylines;
 	std::map<int, Texture*> _textures;
+
+	/// Polygon with cached trigonometry of its points.
+	struct PolygonPoints
+	{
+		Polygon *polygon;
+		std::vector<double> lon, cosLat, sinLat;
+	};
+	std::vector<PolygonPoints> _polygonPoints;
+	std::vector<std::vector<int>> _polygonGrid;
 public:
 	/// Creates a blank globe ruleset.
 	RuleGlobe();
@@ -52,6 +63,10 @@ public:
 	std::list<Polyline*> *getPolylines();
 	/// Loads a set of polygons from a DAT file.
 	void loadDat(const std::string &filename);
+	/// Builds the lookup grid of world polygons.
+	void buildPolygonIndex();
+	/// Gets the world polygon containing a point.
+	Polygon *getPolygonAt(double lon, double lat) const;
 	/// Gets a specific world texture.
 	Texture *getTexture(int id) const;
 	/// Gets all the terrains for a specific deployment.
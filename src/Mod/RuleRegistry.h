@@ -0,0 +1,152 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace OpenXcom
+{
+
+/**
+ * Interned view of one rule type.
+ * Every name of the rule type gets a dense integer id the first time it is seen,
+ * ids are shared by all mods and kept for the whole run, so containers keyed by id
+ * stay valid when mods are reloaded and can keep names no rule uses (eg. from old saves).
+ * Names are resolved by an open addressing hash table. Interning is only for the main thread.
+ * Each mod builds its own id-to-rule array once all its rulesets are loaded.
+ */
+template<typename T>
+class RuleRegistry
+{
+	/// Interned names indexed by id, deque keeps them in place when it grows.
+	inline static std::deque<std::string> _names;
+	/// Hashes of names indexed by id.
+	inline static std::vector<size_t> _hashes;
+	/// Hash table slots, value is id plus one, zero mean empty slot.
+	inline static std::vector<int> _slots;
+
+	/// Rules indexed by id.
+	std::vector<T*> _rules;
+	/// Was registry build.
+	bool _built = false;
+
+	/// Place id in hash table.
+	static void insertSlot(int id)
+	{
+		const auto mask = _slots.size() - 1;
+		auto slot = _hashes[id] & mask;
+		while (_slots[slot])
+		{
+			slot = (slot + 1) & mask;
+		}
+		_slots[slot] = id + 1;
+	}
+
+public:
+	/// Value returned when name is not found.
+	static constexpr int NotFound = -1;
+
+	/// Get id of name, or NotFound if it was never interned.
+	static int find(const std::string& name)
+	{
+		if (_slots.empty())
+		{
+			return NotFound;
+		}
+		const auto hash = std::hash<std::string>{}(name);
+		const auto mask = _slots.size() - 1;
+		for (auto slot = hash & mask; _slots[slot]; slot = (slot + 1) & mask)
+		{
+			const auto id = _slots[slot] - 1;
+			if (_hashes[id] == hash && _names[id] == name)
+			{
+				return id;
+			}
+		}
+		return NotFound;
+	}
+
+	/// Get id of name, giving it new id if it was never seen.
+	static int intern(const std::string& name)
+	{
+		int id = find(name);
+		if (id != NotFound)
+		{
+			return id;
+		}
+		id = (int)_names.size();
+		_names.push_back(name);
+		_hashes.push_back(std::hash<std::string>{}(name));
+		if (_names.size() * 2 > _slots.size())
+		{
+			_slots.assign(std::max<size_t>(16, _slots.size() * 2), 0);
+			for (int i = 0; i < (int)_names.size(); ++i)
+			{
+				insertSlot(i);
+			}
+		}
+		else
+		{
+			insertSlot(id);
+		}
+		return id;
+	}
+
+	/// Get name of id.
+	static const std::string& getName(int id)
+	{
+		return _names[id];
+	}
+
+	/// Build registry from rule map, names are interned in order of map.
+	void build(const std::map<std::string, T*>& map)
+	{
+		_rules.clear();
+		for (auto& p : map)
+		{
+			if (p.second)
+			{
+				const auto id = intern(p.first);
+				if (id >= (int)_rules.size())
+				{
+					_rules.resize(id + 1, nullptr);
+				}
+				_rules[id] = p.second;
+			}
+		}
+		_built = true;
+	}
+
+	/// Was registry build.
+	bool isBuilt() const
+	{
+		return _built;
+	}
+
+	/// Get rule by id.
+	T* get(int id) const
+	{
+		return (id >= 0 && id < (int)_rules.size()) ? _rules[id] : nullptr;
+	}
+};
+
+}
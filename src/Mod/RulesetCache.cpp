@@ -0,0 +1,339 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RulesetCache.h"
+#include <sstream>
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+#include "../version.h"
+
+namespace OpenXcom
+{
+
+namespace RulesetCache
+{
+
+namespace
+{
+
+/// Magic and format version at beginning of cache file.
+const char CacheMagic[8] = { 'O', 'X', 'C', 'R', 'U', 'L', 0, 1 };
+
+/// Node types stored in cache.
+enum CacheNodeType : Uint8
+{
+	CACHE_NULL,
+	CACHE_SCALAR,
+	CACHE_SEQUENCE,
+	CACHE_MAP,
+};
+
+/**
+ * Adds data to FNV-1a hash.
+ */
+void hashAdd(Uint64 &hash, const void *data, size_t size)
+{
+	const Uint8 *p = (const Uint8 *)data;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= p[i];
+		hash *= 1099511628211ull;
+	}
+}
+
+void hashAdd(Uint64 &hash, const std::string &s)
+{
+	Uint64 size = s.size();
+	hashAdd(hash, &size, sizeof(size));
+	hashAdd(hash, s.data(), s.size());
+}
+
+void writeNumber(std::string &out, Uint64 value)
+{
+	while (value >= 0x80)
+	{
+		out += (char)(0x80 | (value & 0x7F));
+		value >>= 7;
+	}
+	out += (char)value;
+}
+
+void writeString(std::string &out, const std::string &s)
+{
+	writeNumber(out, s.size());
+	out += s;
+}
+
+/**
+ * Reader of encoded data, throw on any corruption.
+ */
+struct Reader
+{
+	const char *curr;
+	const char *end;
+
+	Uint64 readNumber()
+	{
+		Uint64 value = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			if (curr == end)
+			{
+				throw Exception("Ruleset cache is truncated");
+			}
+			Uint8 b = (Uint8)*curr++;
+			value |= (Uint64)(b & 0x7F) << shift;
+			if ((b & 0x80) == 0)
+			{
+				return value;
+			}
+		}
+		throw Exception("Ruleset cache is corrupted");
+	}
+
+	std::string readString()
+	{
+		Uint64 size = readNumber();
+		if (size > (Uint64)(end - curr))
+		{
+			throw Exception("Ruleset cache is truncated");
+		}
+		std::string s(curr, (size_t)size);
+		curr += size;
+		return s;
+	}
+
+	Uint8 readByte()
+	{
+		if (curr == end)
+		{
+			throw Exception("Ruleset cache is truncated");
+		}
+		return (Uint8)*curr++;
+	}
+};
+
+void encodeNode(std::string &out, const YAML::Node &node)
+{
+	switch (node.Type())
+	{
+	case YAML::NodeType::Scalar:
+		out += (char)CACHE_SCALAR;
+		writeString(out, node.Tag());
+		writeString(out, node.Scalar());
+		break;
+	case YAML::NodeType::Sequence:
+		out += (char)CACHE_SEQUENCE;
+		writeString(out, node.Tag());
+		writeNumber(out, node.size());
+		for (const YAML::Node &i : node)
+		{
+			encodeNode(out, i);
+		}
+		break;
+	case YAML::NodeType::Map:
+		out += (char)CACHE_MAP;
+		writeString(out, node.Tag());
+		writeNumber(out, node.size());
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			encodeNode(out, i->first);
+			encodeNode(out, i->second);
+		}
+		break;
+	default:
+		out += (char)CACHE_NULL;
+		writeString(out, node.Tag());
+		break;
+	}
+}
+
+YAML::Node decodeNode(Reader &in)
+{
+	Uint8 type = in.readByte();
+	std::string tag = in.readString();
+	YAML::Node node;
+	switch (type)
+	{
+	case CACHE_NULL:
+		node = YAML::Node(YAML::NodeType::Null);
+		break;
+	case CACHE_SCALAR:
+		node = YAML::Node(in.readString());
+		break;
+	case CACHE_SEQUENCE:
+		{
+			node = YAML::Node(YAML::NodeType::Sequence);
+			Uint64 size = in.readNumber();
+			for (Uint64 i = 0; i < size; ++i)
+			{
+				node.push_back(decodeNode(in));
+			}
+		}
+		break;
+	case CACHE_MAP:
+		{
+			node = YAML::Node(YAML::NodeType::Map);
+			Uint64 size = in.readNumber();
+			for (Uint64 i = 0; i < size; ++i)
+			{
+				YAML::Node key = decodeNode(in);
+				YAML::Node value = decodeNode(in);
+				node.force_insert(key, value);
+			}
+		}
+		break;
+	default:
+		throw Exception("Ruleset cache is corrupted");
+	}
+	node.SetTag(tag);
+	return node;
+}
+
+}
+
+/**
+ * Computes key of current build and ruleset files of all mods.
+ * Any change in mod list, file list, file content or game version give different key.
+ * @param mods List of mods with their ruleset files.
+ * @return Key of cache.
+ */
+Uint64 getKey(const FileMap::RSOrder &mods)
+{
+	Uint64 hash = 14695981039346656037ull;
+	hashAdd(hash, CacheMagic, sizeof(CacheMagic));
+	hashAdd(hash, OPENXCOM_VERSION_SHORT OPENXCOM_VERSION_GIT " " __DATE__ " " __TIME__);
+	for (const auto &mod : mods)
+	{
+		hashAdd(hash, mod.first);
+		for (const auto &file : mod.second)
+		{
+			Uint64 stamp = file.getStamp();
+			hashAdd(hash, file.fullpath);
+			hashAdd(hash, &stamp, sizeof(stamp));
+		}
+	}
+	return hash;
+}
+
+/**
+ * Encodes YAML document to binary form, keeping node tags and order of map keys.
+ * @param node Document to encode.
+ * @return Encoded data.
+ */
+std::string encode(const YAML::Node &node)
+{
+	std::string out;
+	encodeNode(out, node);
+	return out;
+}
+
+/**
+ * Decodes YAML document from binary form.
+ * @param data Encoded data.
+ * @return Decoded document.
+ */
+YAML::Node decode(const std::string &data)
+{
+	Reader in = { data.data(), data.data() + data.size() };
+	return decodeNode(in);
+}
+
+/**
+ * Reads encoded documents of all ruleset files from cache file.
+ * @param filename Path of cache file.
+ * @param key Expected key of cache.
+ * @param mods List of mods with their ruleset files.
+ * @param data Encoded documents grouped by mod.
+ * @return True if cache was valid and match key.
+ */
+bool load(const std::string &filename, Uint64 key, const FileMap::RSOrder &mods, std::vector<std::vector<std::string>> &data)
+{
+	if (!CrossPlatform::fileExists(filename))
+	{
+		return false;
+	}
+	try
+	{
+		std::ostringstream buffer;
+		buffer << CrossPlatform::readFile(filename)->rdbuf();
+		const std::string file = buffer.str();
+
+		if (file.size() < sizeof(CacheMagic) || file.compare(0, sizeof(CacheMagic), CacheMagic, sizeof(CacheMagic)) != 0)
+		{
+			return false;
+		}
+		Reader in = { file.data() + sizeof(CacheMagic), file.data() + file.size() };
+		if (in.readNumber() != key || in.readNumber() != mods.size())
+		{
+			return false;
+		}
+		data.clear();
+		data.resize(mods.size());
+		for (size_t i = 0; i < mods.size(); ++i)
+		{
+			if (in.readNumber() != mods[i].second.size())
+			{
+				return false;
+			}
+			for (size_t j = 0; j < mods[i].second.size(); ++j)
+			{
+				data[i].push_back(in.readString());
+			}
+		}
+		return true;
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_WARNING) << "Failed to load ruleset cache: " << e.what();
+		return false;
+	}
+}
+
+/**
+ * Writes encoded documents of all ruleset files to cache file.
+ * @param filename Path of cache file.
+ * @param key Key of cache.
+ * @param data Encoded documents grouped by mod.
+ * @return True on success.
+ */
+bool save(const std::string &filename, Uint64 key, const std::vector<std::vector<std::string>> &data)
+{
+	std::string out(CacheMagic, sizeof(CacheMagic));
+	writeNumber(out, key);
+	writeNumber(out, data.size());
+	for (const auto &mod : data)
+	{
+		writeNumber(out, mod.size());
+		for (const auto &file : mod)
+		{
+			writeString(out, file);
+		}
+	}
+	if (!CrossPlatform::writeFile(filename, out))
+	{
+		Log(LOG_WARNING) << "Failed to save ruleset cache: " << filename;
+		return false;
+	}
+	return true;
+}
+
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+#include <SDL_stdinc.h>
+#include "../Engine/FileMap.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Binary snapshot of parsed ruleset files, used to skip YAML parsing
+ * when the same mods are loaded again.
+ */
+namespace RulesetCache
+{
+	/// Computes key of current build and ruleset files of all mods.
+	Uint64 getKey(const FileMap::RSOrder &mods);
+	/// Encodes YAML document to binary form.
+	std::string encode(const YAML::Node &node);
+	/// Decodes YAML document from binary form.
+	YAML::Node decode(const std::string &data);
+	/// Reads encoded documents of all ruleset files from cache file.
+	bool load(const std::string &filename, Uint64 key, const FileMap::RSOrder &mods, std::vector<std::vector<std::string>> &data);
+	/// Writes encoded documents of all ruleset files to cache file.
+	bool save(const std::string &filename, Uint64 key, const std::vector<std::vector<std::string>> &data);
+}
+
+}
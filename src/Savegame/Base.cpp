@@ -166,16 +166,14 @@ void Base::load(const YAML::Node &node, SavedGame *save, bool newGame, bool newB
 
 	_items->load(node["items"]);
 	// Some old saves have bad items, better get rid of them to avoid further bugs
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
+	for (std::map<int, int>::const_iterator i = _items->getContents().begin(); i != _items->getContents().end();)
 	{
-		if (_mod->getItem(i->first) == 0)
+		std::map<int, int>::const_iterator tmp = i;
+		++i;
+		if (_mod->getItemById(tmp->first) == 0)
 		{
-			Log(LOG_ERROR) << "Failed to load item " << i->first;
-			_items->getContents()->erase(i++);
-		}
-		else
-		{
-			++i;
+			Log(LOG_ERROR) << "Failed to load item " << ItemContainer::getItemType(tmp->first);
+			_items->removeItem(tmp->first, tmp->second);
 		}
 	}
 
@@ -678,9 +676,9 @@ int Base::getTotalOtherStaffAndInventoryCost(int& staffCount, int& inventoryCoun
 			}
 		}
 	}
-	for (const auto& storeItem : *_items->getContents())
+	for (const auto& storeItem : _items->getContents())
 	{
-		auto ruleItem = _mod->getItem(storeItem.first, true);
+		auto ruleItem = _mod->getItemById(storeItem.first, true);
 		if (ruleItem->getMonthlySalary() != 0)
 		{
 			staffCount += storeItem.second;
@@ -694,9 +692,9 @@ int Base::getTotalOtherStaffAndInventoryCost(int& staffCount, int& inventoryCoun
 	}
 	for (auto craft : _crafts)
 	{
-		for (const auto &craftItem : *craft->getItems()->getContents())
+		for (const auto &craftItem : craft->getItems()->getContents())
 		{
-			auto ruleItem = _mod->getItem(craftItem.first, true);
+			auto ruleItem = _mod->getItemById(craftItem.first, true);
 			if (ruleItem->getMonthlySalary() != 0)
 			{
 				staffCount += craftItem.second;
@@ -1425,9 +1423,9 @@ int Base::getUsedContainment(int prisonType) const
 {
 	int total = 0;
 	RuleItem *rule = 0;
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); ++i)
+	for (std::map<int, int>::const_iterator i = _items->getContents().begin(); i != _items->getContents().end(); ++i)
 	{
-		rule = _mod->getItem((i)->first, true);
+		rule = _mod->getItemById((i)->first, true);
 		if (rule->isAlien() && rule->getPrisonType() == prisonType)
 		{
 			total += (i)->second;
@@ -1577,11 +1575,11 @@ void Base::setupDefenses()
 	}
 
 	// add vehicles left on the base
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); )
+	for (std::map<int, int>::const_iterator i = _items->getContents().begin(); i != _items->getContents().end(); )
 	{
-		std::string itemId = (i)->first;
+		int itemId = (i)->first;
 		int itemQty = (i)->second;
-		RuleItem *rule = _mod->getItem(itemId, true);
+		RuleItem *rule = _mod->getItemById(itemId, true);
 		if (rule->getVehicleUnit())
 		{
 			int size = rule->getVehicleUnit()->getArmor()->getTotalSize();
@@ -1617,7 +1615,7 @@ void Base::setupDefenses()
 				_items->removeItem(itemId, canBeAdded);
 			}
 
-			i = _items->getContents()->begin(); // we have to start over because iterator is broken because of the removeItem
+			i = _items->getContents().begin(); // we have to start over because iterator is broken because of the removeItem
 		}
 		else ++i;
 	}
@@ -1857,9 +1855,9 @@ void Base::destroyFacility(std::vector<BaseFacility*>::iterator facility)
 			}
 
 			// remove all items
-			while (!(*facility)->getCraftForDrawing()->getItems()->getContents()->empty())
+			while (!(*facility)->getCraftForDrawing()->getItems()->empty())
 			{
-				std::map<std::string, int>::iterator i = (*facility)->getCraftForDrawing()->getItems()->getContents()->begin();
+				std::map<int, int>::const_iterator i = (*facility)->getCraftForDrawing()->getItems()->getContents().begin();
 				_items->addItem(i->first, i->second);
 				(*facility)->getCraftForDrawing()->getItems()->removeItem(i->first, i->second);
 			}
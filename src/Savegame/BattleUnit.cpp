@@ -54,6 +54,14 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Changed every time any unit moves or changes size.
+size_t PositionVersion = 0;
+
+}
+
 /**
  * Initializes a BattleUnit from a Soldier
  * @param soldier Pointer to the Soldier.
@@ -199,6 +207,7 @@ void BattleUnit::updateArmorFromSoldier(const Mod *mod, Soldier *soldier, Armor
 {
 	_stats = *soldier->getCurrentStats();
 	_armor = ruleArmor;
+	_moveVersion = ++PositionVersion;
 
 	_standHeight = _armor->getStandHeight() == -1 ? soldier->getRules()->getStandHeight() : _armor->getStandHeight();
 	_kneelHeight = _armor->getKneelHeight() == -1 ? soldier->getRules()->getKneelHeight() : _armor->getKneelHeight();
@@ -577,6 +586,7 @@ void BattleUnit::load(const YAML::Node &node, const Mod *mod, const ScriptGlobal
 	_wantsToSurrender = node["wantsToSurrender"].as<bool>(_wantsToSurrender);
 	_isSurrendering = node["isSurrendering"].as<bool>(_isSurrendering);
 	_pos = node["position"].as<Position>(_pos);
+	_moveVersion = ++PositionVersion;
 	_direction = _toDirection = node["direction"].as<int>(_direction);
 	_directionTurret = _toDirectionTurret = node["directionTurret"].as<int>(_directionTurret);
 	_tu = node["tu"].as<int>(_tu);
@@ -795,6 +805,7 @@ void BattleUnit::setPosition(Position pos, bool updateLastPos)
 {
 	if (updateLastPos) { _lastPos = _pos; }
 	_pos = pos;
+	_moveVersion = ++PositionVersion;
 }
 
 /**
@@ -806,6 +817,25 @@ Position BattleUnit::getPosition() const
 	return _pos;
 }
 
+/**
+ * Gets counter changed every time any unit moves or changes size,
+ * used to find out that positions of units need to be indexed again.
+ * @return Version of unit positions.
+ */
+size_t BattleUnit::getPositionVersion()
+{
+	return PositionVersion;
+}
+
+/**
+ * Gets version of unit positions from the last time this unit moved or changed size.
+ * @return Version of unit positions.
+ */
+size_t BattleUnit::getMoveVersion() const
+{
+	return _moveVersion;
+}
+
 /**
  * Gets the BattleUnit's position.
  * @return position
@@ -1013,6 +1043,7 @@ void BattleUnit::keepWalking(SavedBattleGame *savedBattleGame, bool fullWalkCycl
 	if (!fullWalkCycle)
 	{
 		_pos = _destination;
+		_moveVersion = ++PositionVersion;
 		end = 2;
 	}
 
@@ -1023,6 +1054,7 @@ void BattleUnit::keepWalking(SavedBattleGame *savedBattleGame, bool fullWalkCycl
 		// we assume we reached our destination tile
 		// this is actually a drawing hack, so soldiers are not overlapped by floor tiles
 		_pos = _destination;
+		_moveVersion = ++PositionVersion;
 	}
 
 	if (!fullWalkCycle || (_walkPhase == middle))
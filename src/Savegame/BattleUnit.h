@@ -123,6 +123,7 @@ private:
 	BattleUnit *_charging;
 	int _turnsSinceSpotted, _turnsLeftSpottedForSnipers, _turnsSinceStunned = 255;
 	const Unit *_spawnUnit = nullptr;
+	size_t _moveVersion = 0;
 	std::string _activeHand;
 	std::string _preferredHandForReactions;
 	BattleUnitStatistics* _statistics;
@@ -216,6 +217,10 @@ public:
 	void setPosition(Position pos, bool updateLastPos = true);
 	/// Gets the unit's position.
 	Position getPosition() const;
+	/// Gets version of positions of all units.
+	static size_t getPositionVersion();
+	/// Gets version of positions when this unit last moved.
+	size_t getMoveVersion() const;
 	/// Gets the unit's position.
 	Position getLastPosition() const;
 	/// Gets the unit's position of center in voxels.
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattleUnitIndex.h"
+#include <algorithm>
+#include "BattleUnit.h"
+#include "../Mod/Armor.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates empty index.
+ */
+BattleUnitIndex::BattleUnitIndex() : _mapSizeX(0), _mapSizeY(0), _cellsX(0), _cellsY(0), _maxSize(1), _version(0), _count(0), _data(nullptr), _valid(false)
+{
+
+}
+
+/**
+ * Gets cell of position, big units are indexed by their top left corner.
+ * @param pos Position on the map.
+ * @return Index of cell or -1 if position is outside of the map.
+ */
+int BattleUnitIndex::getCell(Position pos) const
+{
+	if (pos.x < 0 || pos.y < 0 || pos.x >= _mapSizeX || pos.y >= _mapSizeY)
+	{
+		return -1;
+	}
+	return (pos.y / CellSize) * _cellsX + pos.x / CellSize;
+}
+
+/**
+ * Indexes all units again.
+ * @param units List of all units.
+ * @param mapSizeX Width of the map.
+ * @param mapSizeY Length of the map.
+ */
+void BattleUnitIndex::rebuild(const std::vector<BattleUnit*> &units, int mapSizeX, int mapSizeY)
+{
+	_mapSizeX = mapSizeX;
+	_mapSizeY = mapSizeY;
+	_cellsX = (mapSizeX + CellSize - 1) / CellSize;
+	_cellsY = (mapSizeY + CellSize - 1) / CellSize;
+	_cells.resize(_cellsX * _cellsY);
+	for (auto &cell : _cells)
+	{
+		cell.clear();
+	}
+	_outside.clear();
+	_unitCells.resize(units.size());
+	_order.clear();
+	_maxSize = 1;
+
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		BattleUnit *unit = units[i];
+		const int cell = getCell(unit->getPosition());
+		_order[unit] = i;
+		_unitCells[i] = cell;
+		_maxSize = std::max(_maxSize, unit->getArmor()->getSize());
+		getCellUnits(cell).push_back(Entry{ i, unit });
+	}
+
+	_version = BattleUnit::getPositionVersion();
+	_count = units.size();
+	_data = units.data();
+	_valid = true;
+}
+
+/**
+ * Moves units that changed position or size since last update to their new cells.
+ * Rebuilds whole index if the list of units or the map changed.
+ * @param units List of all units.
+ * @param mapSizeX Width of the map.
+ * @param mapSizeY Length of the map.
+ */
+void BattleUnitIndex::update(const std::vector<BattleUnit*> &units, int mapSizeX, int mapSizeY)
+{
+	if (!_valid || _count != units.size() || _data != units.data() || _mapSizeX != mapSizeX || _mapSizeY != mapSizeY)
+	{
+		rebuild(units, mapSizeX, mapSizeY);
+		return;
+	}
+
+	const size_t version = BattleUnit::getPositionVersion();
+	if (_version == version)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		BattleUnit *unit = units[i];
+		if (unit->getMoveVersion() <= _version)
+		{
+			continue;
+		}
+		_maxSize = std::max(_maxSize, unit->getArmor()->getSize());
+		const int cell = getCell(unit->getPosition());
+		if (cell == _unitCells[i])
+		{
+			continue;
+		}
+		auto &from = getCellUnits(_unitCells[i]);
+		auto entry = std::find_if(from.begin(), from.end(), [&](const Entry &e) { return e.order == i; });
+		*entry = from.back();
+		from.pop_back();
+		getCellUnits(cell).push_back(Entry{ i, unit });
+		_unitCells[i] = cell;
+	}
+	_version = version;
+}
+
+/**
+ * Adds units from cell to result.
+ * @param x Cell column.
+ * @param y Cell row.
+ */
+void BattleUnitIndex::addCell(int x, int y)
+{
+	const auto &cell = _cells[y * _cellsX + x];
+	_found.insert(_found.end(), cell.begin(), cell.end());
+}
+
+/**
+ * Gets units that can be within given 2d distance from position.
+ * Result can contain more distant units too, callers still need to check the distance.
+ * Units outside of the map are always included.
+ * @param pos Center of the search.
+ * @param range Distance in tiles, any part of big unit can be in range.
+ * @param extra Optional units that need to be in result too.
+ * @param result Gets units in the same order as in list of all units, reusing its memory.
+ */
+void BattleUnitIndex::getUnitsInRange(Position pos, int range, const std::vector<BattleUnit*> *extra, std::vector<BattleUnit*> &result)
+{
+	_found.assign(_outside.begin(), _outside.end());
+
+	// big units are indexed by their top left corner
+	const int minX = std::max(0, (pos.x - range - (_maxSize - 1)) / CellSize);
+	const int minY = std::max(0, (pos.y - range - (_maxSize - 1)) / CellSize);
+	const int maxX = std::min(_cellsX - 1, (pos.x + range) / CellSize);
+	const int maxY = std::min(_cellsY - 1, (pos.y + range) / CellSize);
+	if (pos.x + range >= 0 && pos.y + range >= 0)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			for (int x = minX; x <= maxX; ++x)
+			{
+				addCell(x, y);
+			}
+		}
+	}
+
+	if (extra)
+	{
+		for (BattleUnit *unit : *extra)
+		{
+			auto i = _order.find(unit);
+			if (i != _order.end())
+			{
+				_found.push_back(Entry{ i->second, unit });
+			}
+		}
+	}
+
+	// cells are not kept sorted after units move, callers depend on stable order
+	std::sort(_found.begin(), _found.end(), [](const Entry &a, const Entry &b) { return a.order < b.order; });
+	result.clear();
+	for (const auto &e : _found)
+	{
+		if (result.empty() || result.back() != e.unit)
+		{
+			result.push_back(e.unit);
+		}
+	}
+}
+
+}
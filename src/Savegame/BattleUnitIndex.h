@@ -0,0 +1,77 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <unordered_map>
+#include "../Battlescape/Position.h"
+
+namespace OpenXcom
+{
+
+class BattleUnit;
+
+/**
+ * Uniform grid of battle units, used to find units near some position
+ * without going through every unit on the map.
+ * Units that moved are moved to their new cell on next update,
+ * whole grid is rebuilt only when the list of units changes,
+ * which SavedBattleGame::invalidateUnitIndex reports.
+ */
+class BattleUnitIndex
+{
+private:
+	static const int CellSize = 8;
+
+	/// Unit with its place in the list of all units.
+	struct Entry
+	{
+		size_t order;
+		BattleUnit *unit;
+	};
+
+	std::vector<std::vector<Entry>> _cells;
+	std::vector<Entry> _outside;
+	std::vector<int> _unitCells;
+	std::unordered_map<const BattleUnit*, size_t> _order;
+	std::vector<Entry> _found;
+	int _mapSizeX, _mapSizeY, _cellsX, _cellsY, _maxSize;
+	size_t _version, _count;
+	const BattleUnit *const *_data;
+	bool _valid;
+
+	/// Gets cell of position, -1 for outside of the map.
+	int getCell(Position pos) const;
+	/// Gets list of units in cell.
+	std::vector<Entry> &getCellUnits(int cell) { return cell < 0 ? _outside : _cells[cell]; }
+	/// Indexes all units again.
+	void rebuild(const std::vector<BattleUnit*> &units, int mapSizeX, int mapSizeY);
+	/// Adds units from cell to result.
+	void addCell(int x, int y);
+public:
+	/// Creates empty index.
+	BattleUnitIndex();
+	/// Moves units that changed position since last update to their new cells.
+	void update(const std::vector<BattleUnit*> &units, int mapSizeX, int mapSizeY);
+	/// Forces rebuild on next update.
+	void invalidate() { _valid = false; }
+	/// Gets units that can be within given distance, in order of list of all units.
+	void getUnitsInRange(Position pos, int range, const std::vector<BattleUnit*> *extra, std::vector<BattleUnit*> &result);
+};
+
+}
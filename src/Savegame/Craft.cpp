@@ -144,16 +144,14 @@ void Craft::load(const YAML::Node &node, const Mod *mod, SavedGame *save)
 
 	_items->load(node["items"]);
 	// Some old saves have bad items, better get rid of them to avoid further bugs
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
+	for (std::map<int, int>::const_iterator i = _items->getContents().begin(); i != _items->getContents().end();)
 	{
-		if (mod->getItem(i->first) == 0)
+		std::map<int, int>::const_iterator tmp = i;
+		++i;
+		if (mod->getItemById(tmp->first) == 0)
 		{
-			Log(LOG_ERROR) << "Failed to load item " << i->first;
-			_items->getContents()->erase(i++);
-		}
-		else
-		{
-			++i;
+			Log(LOG_ERROR) << "Failed to load item " << ItemContainer::getItemType(tmp->first);
+			_items->removeItem(tmp->first, tmp->second);
 		}
 	}
 	for (YAML::const_iterator i = node["vehicles"].begin(); i != node["vehicles"].end(); ++i)
@@ -1632,7 +1630,7 @@ void Craft::unload()
 	}
 
 	// Remove items
-	for (std::map<std::string, int>::iterator it = _items->getContents()->begin(); it != _items->getContents()->end(); ++it)
+	for (std::map<int, int>::const_iterator it = _items->getContents().begin(); it != _items->getContents().end(); ++it)
 	{
 		_base->getStorageItems()->addItem(it->first, it->second);
 	}
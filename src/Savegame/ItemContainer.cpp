@@ -19,6 +19,7 @@
 #include "ItemContainer.h"
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
+#include "../Mod/RuleRegistry.h"
 
 namespace OpenXcom
 {
@@ -43,7 +44,10 @@ ItemContainer::~ItemContainer()
  */
 void ItemContainer::load(const YAML::Node &node)
 {
-	_qty = node.as< std::map<std::string, int> >(_qty);
+	for (auto &i : node.as< std::map<std::string, int> >(std::map<std::string, int>()))
+	{
+		_qty[getItemId(i.first)] = i.second;
+	}
 }
 
 /**
@@ -52,11 +56,26 @@ void ItemContainer::load(const YAML::Node &node)
  */
 YAML::Node ItemContainer::save() const
 {
+	std::map<std::string, int> qty;
+	for (auto &i : _qty)
+	{
+		qty[getItemType(i.first)] = i.second;
+	}
 	YAML::Node node;
-	node = _qty;
+	node = qty;
 	return node;
 }
 
+/**
+ * Adds an item amount to the container.
+ * @param id Interned item ID.
+ * @param qty Item quantity.
+ */
+void ItemContainer::addItem(int id, int qty)
+{
+	_qty[id] += qty;
+}
+
 /**
  * Adds an item amount to the container.
  * @param id Item ID.
@@ -68,7 +87,7 @@ void ItemContainer::addItem(const std::string &id, int qty)
 	{
 		return;
 	}
-	_qty[id] += qty;
+	addItem(getItemId(id), qty);
 }
 
 /**
@@ -86,15 +105,11 @@ void ItemContainer::addItem(const RuleItem* item, int qty)
 
 /**
  * Removes an item amount from the container.
- * @param id Item ID.
+ * @param id Interned item ID.
  * @param qty Item quantity.
  */
-void ItemContainer::removeItem(const std::string &id, int qty)
+void ItemContainer::removeItem(int id, int qty)
 {
-	if (id.empty())
-	{
-		return;
-	}
 	auto it = _qty.find(id);
 	if (it == _qty.end())
 	{
@@ -111,6 +126,24 @@ void ItemContainer::removeItem(const std::string &id, int qty)
 	}
 }
 
+/**
+ * Removes an item amount from the container.
+ * @param id Item ID.
+ * @param qty Item quantity.
+ */
+void ItemContainer::removeItem(const std::string &id, int qty)
+{
+	if (id.empty())
+	{
+		return;
+	}
+	int i = RuleRegistry<RuleItem>::find(id);
+	if (i != RuleRegistry<RuleItem>::NotFound)
+	{
+		removeItem(i, qty);
+	}
+}
+
 /**
  * Removes an item amount from the container.
  * @param id Item ID.
@@ -126,16 +159,11 @@ void ItemContainer::removeItem(const RuleItem* item, int qty)
 
 /**
  * Returns the quantity of an item in the container.
- * @param id Item ID.
+ * @param id Interned item ID.
  * @return Item quantity.
  */
-int ItemContainer::getItem(const std::string &id) const
+int ItemContainer::getItem(int id) const
 {
-	if (id.empty())
-	{
-		return 0;
-	}
-
 	auto it = _qty.find(id);
 	if (it == _qty.end())
 	{
@@ -147,6 +175,25 @@ int ItemContainer::getItem(const std::string &id) const
 	}
 }
 
+/**
+ * Returns the quantity of an item in the container.
+ * @param id Item ID.
+ * @return Item quantity.
+ */
+int ItemContainer::getItem(const std::string &id) const
+{
+	if (id.empty())
+	{
+		return 0;
+	}
+	int i = RuleRegistry<RuleItem>::find(id);
+	if (i == RuleRegistry<RuleItem>::NotFound)
+	{
+		return 0;
+	}
+	return getItem(i);
+}
+
 /**
  * Returns the quantity of an item in the container.
  * @param id Item ID.
@@ -171,9 +218,9 @@ int ItemContainer::getItem(const RuleItem* item) const
 int ItemContainer::getTotalQuantity() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (auto &i : _qty)
 	{
-		total += i->second;
+		total += i.second;
 	}
 	return total;
 }
@@ -186,20 +233,32 @@ int ItemContainer::getTotalQuantity() const
 double ItemContainer::getTotalSize(const Mod *mod) const
 {
 	double total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (auto &i : _qty)
 	{
-		total += mod->getItem(i->first, true)->getSize() * i->second;
+		total += mod->getItemById(i.first, true)->getSize() * i.second;
 	}
 	return total;
 }
 
 /**
- * Returns all the items currently contained within.
- * @return List of contents.
+ * Gets the interned id of an item type, giving it a new one
+ * if it was never seen (eg. an item of a removed mod in a save).
+ * @param type Item type.
+ * @return Interned item ID.
+ */
+int ItemContainer::getItemId(const std::string &type)
+{
+	return RuleRegistry<RuleItem>::intern(type);
+}
+
+/**
+ * Gets the item type of an interned id.
+ * @param id Interned item ID.
+ * @return Item type.
  */
-std::map<std::string, int> *ItemContainer::getContents()
+const std::string &ItemContainer::getItemType(int id)
 {
-	return &_qty;
+	return RuleRegistry<RuleItem>::getName(id);
 }
 
 }
@@ -35,7 +35,8 @@ class RuleItem;
 class ItemContainer
 {
 private:
-	std::map<std::string, int> _qty;
+	/// Item quantities, keyed by item id interned in RuleRegistry<RuleItem>.
+	std::map<int, int> _qty;
 public:
 	/// Creates an empty item container.
 	ItemContainer();
@@ -46,14 +47,20 @@ public:
 	/// Saves the item container to YAML.
 	YAML::Node save() const;
 	/// Adds an item to the container.
+	void addItem(int id, int qty = 1);
+	/// Adds an item to the container.
 	void addItem(const std::string &id, int qty = 1);
 	/// Adds an item to the container.
 	void addItem(const RuleItem* item, int qty = 1);
 	/// Removes an item from the container.
+	void removeItem(int id, int qty = 1);
+	/// Removes an item from the container.
 	void removeItem(const std::string &id, int qty = 1);
 	/// Removes an item from the container.
 	void removeItem(const RuleItem* item, int qty = 1);
 	/// Gets an item in the container.
+	int getItem(int id) const;
+	/// Gets an item in the container.
 	int getItem(const std::string &id) const;
 	/// Gets an item in the container.
 	int getItem(const RuleItem* item) const;
@@ -61,8 +68,16 @@ public:
 	int getTotalQuantity() const;
 	/// Gets the total size of items in the container.
 	double getTotalSize(const Mod *mod) const;
-	/// Gets all the items in the container.
-	std::map<std::string, int> *getContents();
+	/// Gets all the items in the container, keyed by item id.
+	const std::map<int, int> &getContents() const { return _qty; }
+	/// Is the container empty?
+	bool empty() const { return _qty.empty(); }
+	/// Removes all items from the container.
+	void clear() { _qty.clear(); }
+	/// Gets the interned id of an item type.
+	static int getItemId(const std::string &type);
+	/// Gets the item type of an interned id.
+	static const std::string &getItemType(int id);
 };
 
 }
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ReachabilityCache.h"
+#include "BattleUnit.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Gets the path cost of a tile.
+ * @param tileIndex Index of the tile.
+ * @return Cost of the cheapest path, or -1 if the search didn't reach the tile.
+ */
+int ReachabilityCache::Field::getCost(int tileIndex) const
+{
+	auto it = costByTile.find(tileIndex);
+	if (it == costByTile.end())
+	{
+		return -1;
+	}
+	return it->second;
+}
+
+/**
+ * Creates an empty cache.
+ */
+ReachabilityCache::ReachabilityCache() : _decisionUnit(nullptr), _decisionStamp(0), _hits(0), _misses(0)
+{
+
+}
+
+/**
+ * Looks up a stored search result.
+ * A field searched with a bigger limit can answer a smaller one,
+ * since every tile within the smaller limit got its final cost.
+ * @param unit The moving unit.
+ * @param startIndex Tile index the search starts from.
+ * @param movementType Movement type used by the search.
+ * @param limit Largest path cost wanted.
+ * @param unitsStamp Current value of getUnitsStamp().
+ * @return The stored field or null if the search has to be run.
+ */
+const ReachabilityCache::Field *ReachabilityCache::find(const BattleUnit *unit, int startIndex, MovementType movementType, int limit, size_t unitsStamp)
+{
+	auto it = _entries.find(Key{ unit->getId(), startIndex, movementType });
+	if (it != _entries.end() && it->second.unitsStamp == unitsStamp && it->second.field.limit >= limit)
+	{
+		++_hits;
+		return &it->second.field;
+	}
+	++_misses;
+	return nullptr;
+}
+
+/**
+ * Stores the result of a search.
+ * @param unit The moving unit.
+ * @param startIndex Tile index the search started from.
+ * @param movementType Movement type used by the search.
+ * @param unitsStamp Value of getUnitsStamp() when the search ran.
+ * @param field The search result.
+ * @return The stored field.
+ */
+const ReachabilityCache::Field *ReachabilityCache::store(const BattleUnit *unit, int startIndex, MovementType movementType, size_t unitsStamp, Field &&field)
+{
+	Entry &entry = _entries[Key{ unit->getId(), startIndex, movementType }];
+	entry.unitsStamp = unitsStamp;
+	entry.field = std::move(field);
+	return &entry.field;
+}
+
+/**
+ * Drops all stored fields, called when terrain or doors change.
+ */
+void ReachabilityCache::invalidate()
+{
+	_entries.clear();
+}
+
+/**
+ * Resets the hit and miss counters.
+ */
+void ReachabilityCache::resetCounters()
+{
+	_hits = 0;
+	_misses = 0;
+}
+
+/**
+ * Gets the stamp of the units a search of a unit depends on.
+ * Computed once while the unit is deciding, see Decision.
+ * @param units All units in the battle.
+ * @param unit The moving unit.
+ * @return Hash of the unit state.
+ */
+size_t ReachabilityCache::getUnitsStamp(const std::vector<BattleUnit*> &units, BattleUnit *unit) const
+{
+	if (unit == _decisionUnit)
+	{
+		return _decisionStamp;
+	}
+	return computeUnitsStamp(units, unit);
+}
+
+/**
+ * Combines everything about units that Pathfinding::isBlocked looks at:
+ * where the units stand, their faction, whether they are out or visible,
+ * and who the moving unit has spotted this turn.
+ * @param units All units in the battle.
+ * @param unit The moving unit.
+ * @return Hash of the unit state.
+ */
+size_t ReachabilityCache::computeUnitsStamp(const std::vector<BattleUnit*> &units, BattleUnit *unit)
+{
+	size_t stamp = unit->getUnitsSpottedThisTurn().size();
+	for (const BattleUnit *bu : units)
+	{
+		const Position pos = bu->getPosition();
+		size_t value = ((size_t)bu->getId() << 24) ^ ((size_t)pos.x << 16) ^ ((size_t)pos.y << 8) ^ (size_t)pos.z;
+		value = (value << 4) | ((size_t)bu->getFaction() << 2) | (bu->isOut() ? 2 : 0) | (bu->getVisible() ? 1 : 0);
+		stamp ^= value + 0x9e3779b9 + (stamp << 6) + (stamp >> 2);
+	}
+	return stamp;
+}
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <unordered_map>
+#include "../Mod/MapData.h"
+
+namespace OpenXcom
+{
+
+class BattleUnit;
+
+/**
+ * Keeps the results of Pathfinding::findReachable for the current map state,
+ * so repeated AI questions about the same unit don't rerun the search.
+ * Entries are dropped when terrain, doors or turn change and ignored when any unit moved.
+ */
+class ReachabilityCache
+{
+public:
+	/**
+	 * Cost of reaching every tile found by one search.
+	 */
+	struct Field
+	{
+		/// Largest path cost the search was allowed to spend.
+		int limit = 0;
+		/// Reached tile indices, in ascending order of cost.
+		std::vector<int> tiles;
+		/// Path cost of each tile in `tiles`.
+		std::vector<int> costs;
+		/// Path cost by tile index.
+		std::unordered_map<int, int> costByTile;
+
+		/// Gets the path cost of a tile, or -1 if it was not reached.
+		int getCost(int tileIndex) const;
+	};
+
+private:
+	struct Key
+	{
+		int unitId;
+		int startIndex;
+		MovementType movementType;
+
+		bool operator==(const Key &other) const
+		{
+			return unitId == other.unitId && startIndex == other.startIndex && movementType == other.movementType;
+		}
+	};
+	struct KeyHash
+	{
+		size_t operator()(const Key &key) const
+		{
+			return ((size_t)key.unitId * 1000003u) ^ ((size_t)key.startIndex << 2) ^ (size_t)key.movementType;
+		}
+	};
+	struct Entry
+	{
+		size_t unitsStamp;
+		Field field;
+	};
+
+	std::unordered_map<Key, Entry, KeyHash> _entries;
+	const BattleUnit *_decisionUnit;
+	size_t _decisionStamp;
+	int _hits, _misses;
+
+	/// Hashes the state of all units that can block a search.
+	static size_t computeUnitsStamp(const std::vector<BattleUnit*> &units, BattleUnit *unit);
+public:
+	/**
+	 * Keeps one units stamp for all searches of a unit while it
+	 * decides what to do, as no unit moves in the meantime.
+	 */
+	class Decision
+	{
+		ReachabilityCache &_cache;
+	public:
+		/// Computes the stamp for the deciding unit.
+		Decision(ReachabilityCache &cache, const std::vector<BattleUnit*> &units, BattleUnit *unit) : _cache(cache)
+		{
+			_cache._decisionStamp = computeUnitsStamp(units, unit);
+			_cache._decisionUnit = unit;
+		}
+		/// Goes back to computing the stamp for every search.
+		~Decision()
+		{
+			_cache._decisionUnit = nullptr;
+		}
+	};
+
+	/// Creates an empty cache.
+	ReachabilityCache();
+	/// Gets a stored field that can answer a search, or null.
+	const Field *find(const BattleUnit *unit, int startIndex, MovementType movementType, int limit, size_t unitsStamp);
+	/// Stores the result of a search, replacing the previous one.
+	const Field *store(const BattleUnit *unit, int startIndex, MovementType movementType, size_t unitsStamp, Field &&field);
+	/// Drops all stored fields.
+	void invalidate();
+	/// Gets the number of searches answered from the cache.
+	int getHits() const { return _hits; }
+	/// Gets the number of searches that had to be run.
+	int getMisses() const { return _misses; }
+	/// Resets the hit and miss counters.
+	void resetCounters();
+	/// Gets a value that changes whenever the units blocking a search change.
+	size_t getUnitsStamp(const std::vector<BattleUnit*> &units, BattleUnit *unit) const;
+};
+
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SaveIndex.h"
+#include <map>
+#include <mutex>
+#include <SDL_stdinc.h>
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Options.h"
+#include "../Engine/Logger.h"
+
+namespace OpenXcom
+{
+
+namespace SaveIndex
+{
+
+namespace
+{
+
+const int IndexVersion = 1;
+const std::string IndexFile = "saves.idx";
+
+/**
+ * Header of one save file with stamp of the file it was read from.
+ */
+struct Entry
+{
+	time_t mtime;
+	Uint64 size;
+	YAML::Node header;
+	bool used;
+};
+
+/**
+ * Index of one master user folder.
+ */
+struct Index
+{
+	std::string folder;
+	std::map<std::string, Entry> entries;
+	bool dirty = false;
+};
+
+Index TheIndex;
+std::mutex TheIndexMutex;
+
+/**
+ * Loads index of current master user folder, if it is not loaded yet.
+ * Broken or outdated index file is ignored, it will be rebuilt.
+ */
+void loadIndex()
+{
+	const std::string folder = Options::getMasterUserFolder();
+	if (TheIndex.folder == folder)
+	{
+		return;
+	}
+	TheIndex = Index();
+	TheIndex.folder = folder;
+
+	const std::string path = folder + IndexFile;
+	if (!CrossPlatform::fileExists(path))
+	{
+		return;
+	}
+	try
+	{
+		YAML::Node doc = YAML::Load(*CrossPlatform::readFile(path));
+		if (doc["version"].as<int>(0) != IndexVersion)
+		{
+			return;
+		}
+		for (const YAML::Node &n : doc["saves"])
+		{
+			Entry &e = TheIndex.entries[n["file"].as<std::string>()];
+			e.mtime = (time_t)n["mtime"].as<long long>();
+			e.size = n["size"].as<Uint64>();
+			e.header = n["header"];
+			e.used = false;
+		}
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_WARNING) << "Ignoring broken save index " << path << ": " << e.what();
+		TheIndex.entries.clear();
+	}
+}
+
+/**
+ * Writes index to the master user folder.
+ */
+void saveIndex()
+{
+	YAML::Emitter out;
+	YAML::Node doc;
+	doc["version"] = IndexVersion;
+	for (const auto &i : TheIndex.entries)
+	{
+		YAML::Node n;
+		n["file"] = i.first;
+		n["mtime"] = (long long)i.second.mtime;
+		n["size"] = i.second.size;
+		n["header"] = i.second.header;
+		doc["saves"].push_back(n);
+	}
+	out << doc;
+	if (CrossPlatform::writeFile(TheIndex.folder + IndexFile, out.c_str()))
+	{
+		TheIndex.dirty = false;
+	}
+	else
+	{
+		Log(LOG_WARNING) << "Failed to write save index " << TheIndex.folder + IndexFile;
+	}
+}
+
+}
+
+/**
+ * Gets header of save file. Index entry is used if the file
+ * still has the same modification time and size, otherwise
+ * the header is read from the file and stored in the index.
+ * @param file Save filename.
+ * @param mtime Modification time of the file.
+ * @return YAML header of the save.
+ */
+YAML::Node getHeader(const std::string &file, time_t mtime)
+{
+	std::lock_guard<std::mutex> lock(TheIndexMutex);
+	loadIndex();
+	const std::string fullname = TheIndex.folder + file;
+	const Uint64 size = CrossPlatform::getFileSize(fullname);
+	auto i = TheIndex.entries.find(file);
+	if (i != TheIndex.entries.end() && i->second.mtime == mtime && i->second.size == size)
+	{
+		i->second.used = true;
+		return i->second.header;
+	}
+
+	YAML::Node header = YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
+	TheIndex.entries[file] = Entry{ mtime, size, header, true };
+	TheIndex.dirty = true;
+	return header;
+}
+
+/**
+ * Stores header of just written save file and writes the index.
+ * @param file Save filename.
+ * @param header YAML header written to the save.
+ */
+void update(const std::string &file, const YAML::Node &header)
+{
+	std::lock_guard<std::mutex> lock(TheIndexMutex);
+	loadIndex();
+	const std::string fullname = TheIndex.folder + file;
+	TheIndex.entries[file] = Entry{ CrossPlatform::getDateModified(fullname), CrossPlatform::getFileSize(fullname), YAML::Clone(header), true };
+	saveIndex();
+}
+
+/**
+ * Drops entries of files that were not used since last flush
+ * and no longer exist, then writes the index if anything changed.
+ */
+void flush()
+{
+	std::lock_guard<std::mutex> lock(TheIndexMutex);
+	loadIndex();
+	for (auto i = TheIndex.entries.begin(); i != TheIndex.entries.end();)
+	{
+		if (!i->second.used && !CrossPlatform::fileExists(TheIndex.folder + i->first))
+		{
+			i = TheIndex.entries.erase(i);
+			TheIndex.dirty = true;
+		}
+		else
+		{
+			i->second.used = false;
+			++i;
+		}
+	}
+	if (TheIndex.dirty)
+	{
+		saveIndex();
+	}
+}
+
+}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <ctime>
+#include <yaml-cpp/yaml.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Index of save file headers stored in the master user folder,
+ * so the save list does not need to open every save file.
+ * Functions are guarded by a lock, saves are written from a worker thread.
+ */
+namespace SaveIndex
+{
+	/// Gets header of save file, reads the file only if it changed.
+	YAML::Node getHeader(const std::string &file, time_t mtime);
+	/// Stores header of just written save file.
+	void update(const std::string &file, const YAML::Node &header);
+	/// Drops entries of deleted files and writes index if it changed.
+	void flush();
+}
+
+}
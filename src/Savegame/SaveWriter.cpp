@@ -0,0 +1,155 @@
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SaveWriter.h"
+#include <SDL.h>
+#include "SaveIndex.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Options.h"
+#include "../Engine/Logger.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates writer with one worker thread.
+ */
+SaveWriter::SaveWriter() : _queued(0), _worker(1)
+{
+
+}
+
+/**
+ * Waits for all queued saves, so nothing is lost on quit.
+ */
+SaveWriter::~SaveWriter()
+{
+	wait();
+}
+
+/**
+ * Queues save buffer to be written in background.
+ * If previous buffer for same file is still waiting it is replaced,
+ * so frequent autosaves only write the newest state.
+ * Needs to be called from main thread.
+ * @param filename Save filename in master user folder.
+ * @param data Serialized save.
+ * @param header Brief info of the save for the save index.
+ */
+void SaveWriter::push(const std::string &filename, std::string data, const YAML::Node &header)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto i = _pending.find(filename);
+		if (i != _pending.end())
+		{
+			i->second.data = std::move(data);
+			i->second.header = YAML::Clone(header);
+			return;
+		}
+		_pending[filename] = Pending{ std::move(data), YAML::Clone(header) };
+		++_queued;
+	}
+	_worker.push([this, filename]{ work(filename); });
+}
+
+/**
+ * Writes newest buffer queued for file.
+ * @param filename Save filename in master user folder.
+ */
+void SaveWriter::work(const std::string &filename)
+{
+	Pending save;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto i = _pending.find(filename);
+		save = std::move(i->second);
+		_pending.erase(i);
+	}
+
+	Uint32 start = SDL_GetTicks();
+	std::string error = write(filename, save.data, save.header);
+	Log(LOG_DEBUG) << "Saved " << filename << " in background in " << SDL_GetTicks() - start << "ms";
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!error.empty())
+	{
+		_errors.push_back(error);
+	}
+	--_queued;
+	_done.notify_all();
+}
+
+/**
+ * Waits until all queued saves are written.
+ * Needs to be called before save files are read or listed.
+ */
+void SaveWriter::wait()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_done.wait(lock, [this]{ return _queued == 0; });
+}
+
+/**
+ * Gets errors of failed background saves since last call.
+ * @return List of error messages.
+ */
+std::vector<std::string> SaveWriter::takeErrors()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<std::string> errors;
+	errors.swap(_errors);
+	return errors;
+}
+
+/**
+ * Writes save buffer to temporary file and moves it over the old save,
+ * so a failed write never destroys previous save.
+ * @param filename Save filename in master user folder.
+ * @param data Serialized save.
+ * @param header Brief info of the save for the save index.
+ * @return Error message, empty if save was written.
+ */
+std::string SaveWriter::write(const std::string &filename, const std::string &data, const YAML::Node &header)
+{
+	std::string backup = filename + ".bak";
+	std::string fullPath = Options::getMasterUserFolder() + filename;
+	std::string bakPath = Options::getMasterUserFolder() + backup;
+	if (!CrossPlatform::writeFile(bakPath, data))
+	{
+		return "Failed to save " + bakPath;
+	}
+	if (!CrossPlatform::moveFile(bakPath, fullPath))
+	{
+		return "Save backed up in " + backup;
+	}
+	SaveIndex::update(filename, header);
+	return "";
+}
+
+/**
+ * Gets writer shared by whole game.
+ * @return Save writer.
+ */
+SaveWriter &SaveWriter::getShared()
+{
+	static SaveWriter writer;
+	return writer;
+}
+
+}
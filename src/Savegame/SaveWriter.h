@@ -0,0 +1,70 @@
+#pragma once
+/*
+ * Copyright 2010-2024 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <yaml-cpp/yaml.h>
+#include "../Engine/WorkerPool.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Writes serialized saves to disk on a background thread.
+ * Game state is serialized on main thread, only file IO is moved out of it.
+ */
+class SaveWriter
+{
+private:
+	struct Pending
+	{
+		std::string data;
+		YAML::Node header;
+	};
+
+	std::map<std::string, Pending> _pending;
+	std::vector<std::string> _errors;
+	std::mutex _mutex;
+	std::condition_variable _done;
+	int _queued;
+	WorkerPool _worker;
+
+	/// Writes newest buffer queued for file on worker thread.
+	void work(const std::string &filename);
+public:
+	/// Creates writer with one worker thread.
+	SaveWriter();
+	/// Waits for all queued saves.
+	~SaveWriter();
+	/// Queues save buffer to be written in background.
+	void push(const std::string &filename, std::string data, const YAML::Node &header);
+	/// Waits until all queued saves are written.
+	void wait();
+	/// Gets errors of failed background saves since last call.
+	std::vector<std::string> takeErrors();
+	/// Writes save buffer to file, returns error message on failure.
+	static std::string write(const std::string &filename, const std::string &data, const YAML::Node &header);
+	/// Gets writer shared by whole game.
+	static SaveWriter &getShared();
+};
+
+}
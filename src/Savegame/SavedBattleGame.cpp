@@ -24,6 +24,8 @@
 #include "SavedGame.h"
 #include "Tile.h"
 #include "HitLog.h"
+#include "ReachabilityCache.h"
+#include "BattleUnitIndex.h"
 #include "Node.h"
 #include "../Mod/MapDataSet.h"
 #include "../Mod/MCDPatch.h"
@@ -77,6 +79,8 @@ SavedBattleGame::SavedBattleGame(Mod *rule, Language *lang) :
 	}
 	_baseItems = new ItemContainer();
 	_hitLog = new HitLog(lang);
+	_reachabilityCache = new ReachabilityCache();
+	_unitIndex = new BattleUnitIndex();
 
 	setRandomHiddenMovementBackground(0);
 }
@@ -122,6 +126,8 @@ SavedBattleGame::~SavedBattleGame()
 	delete _tileEngine;
 	delete _baseItems;
 	delete _hitLog;
+	delete _reachabilityCache;
+	delete _unitIndex;
 }
 
 /**
@@ -450,78 +456,79 @@ void SavedBattleGame::loadMapResources(Mod *mod)
 
 /**
  * Saves the saved battle game to a YAML file.
- * @return YAML node.
+ * Map is written directly to the emitter, only single units
+ * and items are built as YAML nodes.
+ * @param out YAML emitter.
  */
-YAML::Node SavedBattleGame::save() const
+void SavedBattleGame::save(YAML::Emitter &out) const
 {
-	YAML::Node node;
+	YamlMapWriter node(out);
 	if (_vipSurvivalPercentage > 0)
 	{
-		node["vipEscapeType"] = (int)_vipEscapeType;
-		node["vipSurvivalPercentage"] = _vipSurvivalPercentage;
-		node["vipsSaved"] = _vipsSaved;
-		node["vipsLost"] = _vipsLost;
-		node["vipsWaitingOutside"] = _vipsWaitingOutside;
-		node["vipsSavedScore"] = _vipsSavedScore;
-		node["vipsLostScore"] = _vipsLostScore;
-		node["vipsWaitingOutsideScore"] = _vipsWaitingOutsideScore;
+		node.write("vipEscapeType", (int)_vipEscapeType);
+		node.write("vipSurvivalPercentage", _vipSurvivalPercentage);
+		node.write("vipsSaved", _vipsSaved);
+		node.write("vipsLost", _vipsLost);
+		node.write("vipsWaitingOutside", _vipsWaitingOutside);
+		node.write("vipsSavedScore", _vipsSavedScore);
+		node.write("vipsLostScore", _vipsLostScore);
+		node.write("vipsWaitingOutsideScore", _vipsWaitingOutsideScore);
 	}
 	if (_objectivesNeeded)
 	{
-		node["objectivesDestroyed"] = _objectivesDestroyed;
-		node["objectivesNeeded"] = _objectivesNeeded;
-		node["objectiveType"] = _objectiveType;
+		node.write("objectivesDestroyed", _objectivesDestroyed);
+		node.write("objectivesNeeded", _objectivesNeeded);
+		node.write("objectiveType", _objectiveType);
 	}
-	node["width"] = _mapsize_x;
-	node["length"] = _mapsize_y;
-	node["height"] = _mapsize_z;
-	node["missionType"] = _missionType;
-	node["strTarget"] = _strTarget;
-	node["strCraftOrBase"] = _strCraftOrBase;
+	node.write("width", _mapsize_x);
+	node.write("length", _mapsize_y);
+	node.write("height", _mapsize_z);
+	node.write("missionType", _missionType);
+	node.write("strTarget", _strTarget);
+	node.write("strCraftOrBase", _strCraftOrBase);
 	if (_enviroEffects)
 	{
-		node["enviroEffectsType"] = _enviroEffects->getType();
-	}
-	node["nameDisplay"] = _nameDisplay;
-	node["ecEnabledFriendly"] = _ecEnabledFriendly;
-	node["ecEnabledHostile"] = _ecEnabledHostile;
-	node["ecEnabledNeutral"] = _ecEnabledNeutral;
-	node["alienCustomDeploy"] = _alienCustomDeploy;
-	node["alienCustomMission"] = _alienCustomMission;
-	node["reinforcementsDeployment"] = _reinforcementsDeployment;
-	node["reinforcementsRace"] = _reinforcementsRace;
-	node["reinforcementsItemLevel"] = _reinforcementsItemLevel;
-	node["reinforcementsMemory"] = _reinforcementsMemory;
-	node["reinforcementsBlocks"] = _reinforcementsBlocks;
-	node["flattenedMapTerrainNames"] = _flattenedMapTerrainNames;
-	node["flattenedMapBlockNames"] = _flattenedMapBlockNames;
-	node["globalshade"] = _globalShade;
-	node["turn"] = _turn;
-	node["bughuntMinTurn"] = _bughuntMinTurn;
-	node["animFrame"] = _animFrame;
-	node["bughuntMode"] = _bughuntMode;
-	node["selectedUnit"] = (_selectedUnit?_selectedUnit->getId():-1);
-	for (std::vector<MapDataSet*>::const_iterator i = _mapDataSets.begin(); i != _mapDataSets.end(); ++i)
-	{
-		node["mapdatasets"].push_back((*i)->getName());
-	}
+		node.write("enviroEffectsType", _enviroEffects->getType());
+	}
+	node.write("nameDisplay", _nameDisplay);
+	node.write("ecEnabledFriendly", _ecEnabledFriendly);
+	node.write("ecEnabledHostile", _ecEnabledHostile);
+	node.write("ecEnabledNeutral", _ecEnabledNeutral);
+	node.write("alienCustomDeploy", _alienCustomDeploy);
+	node.write("alienCustomMission", _alienCustomMission);
+	node.write("reinforcementsDeployment", _reinforcementsDeployment);
+	node.write("reinforcementsRace", _reinforcementsRace);
+	node.write("reinforcementsItemLevel", _reinforcementsItemLevel);
+	node.write("reinforcementsMemory", _reinforcementsMemory);
+	node.write("reinforcementsBlocks", _reinforcementsBlocks);
+	node.write("flattenedMapTerrainNames", _flattenedMapTerrainNames);
+	node.write("flattenedMapBlockNames", _flattenedMapBlockNames);
+	node.write("globalshade", _globalShade);
+	node.write("turn", _turn);
+	node.write("bughuntMinTurn", _bughuntMinTurn);
+	node.write("animFrame", _animFrame);
+	node.write("bughuntMode", _bughuntMode);
+	node.write("selectedUnit", (_selectedUnit?_selectedUnit->getId():-1));
+	node.writeList("mapdatasets", _mapDataSets, [](const MapDataSet *i) { return i->getName(); });
 #if 0
+	node.key("tiles") << YAML::BeginSeq;
 	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
 	{
 		if (!_tiles[i].isVoid())
 		{
-			node["tiles"].push_back(_tiles[i].save());
+			out << _tiles[i].save();
 		}
 	}
+	out << YAML::EndSeq;
 #else
 	// first, write out the field sizes we're going to use to write the tile data
-	node["tileIndexSize"] = Tile::serializationKey.index;
-	node["tileTotalBytesPer"] = Tile::serializationKey.totalBytes;
-	node["tileFireSize"] = Tile::serializationKey._fire;
-	node["tileSmokeSize"] = Tile::serializationKey._smoke;
-	node["tileIDSize"] = Tile::serializationKey._mapDataID;
-	node["tileSetIDSize"] = Tile::serializationKey._mapDataSetID;
-	node["tileBoolFieldsSize"] = Tile::serializationKey.boolFields;
+	node.write("tileIndexSize", Tile::serializationKey.index);
+	node.write("tileTotalBytesPer", Tile::serializationKey.totalBytes);
+	node.write("tileFireSize", Tile::serializationKey._fire);
+	node.write("tileSmokeSize", Tile::serializationKey._smoke);
+	node.write("tileIDSize", Tile::serializationKey._mapDataID);
+	node.write("tileSetIDSize", Tile::serializationKey._mapDataSetID);
+	node.write("tileBoolFieldsSize", Tile::serializationKey.boolFields);
 
 	size_t tileDataSize = Tile::serializationKey.totalBytes * _mapsize_z * _mapsize_y * _mapsize_x;
 	Uint8* tileData = (Uint8*) calloc(tileDataSize, 1);
@@ -539,51 +546,37 @@ YAML::Node SavedBattleGame::save() const
 			tileDataSize -= Tile::serializationKey.totalBytes;
 		}
 	}
-	node["totalTiles"] = tileDataSize / Tile::serializationKey.totalBytes; // not strictly necessary, just convenient
-	node["binTiles"] = YAML::Binary(tileData, tileDataSize);
+	node.write("totalTiles", tileDataSize / Tile::serializationKey.totalBytes); // not strictly necessary, just convenient
+	node.write("binTiles", YAML::Binary(tileData, tileDataSize));
 	free(tileData);
 #endif
-	for (std::vector<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
-	{
-		node["nodes"].push_back((*i)->save());
-	}
+	node.writeList("nodes", _nodes, [](const Node *i) { return i->save(); });
 	if (_missionType == "STR_BASE_DEFENSE")
 	{
-		node["moduleMap"] = _baseModules;
-	}
-	for (std::vector<BattleUnit*>::const_iterator i = _units.begin(); i != _units.end(); ++i)
-	{
-		node["units"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
-	}
-	for (std::vector<BattleItem*>::const_iterator i = _items.begin(); i != _items.end(); ++i)
-	{
-		node["items"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
-	}
-	node["tuReserved"] = (int)_tuReserved;
-	node["kneelReserved"] = _kneelReserved;
-	node["depth"] = _depth;
-	node["ambience"] = _ambience;
-	node["ambientVolume"] = _ambientVolume;
-	node["ambienceRandom"] = _ambienceRandom;
-	node["minAmbienceRandomDelay"] = _minAmbienceRandomDelay;
-	node["maxAmbienceRandomDelay"] = _maxAmbienceRandomDelay;
-	node["currentAmbienceDelay"] = _currentAmbienceDelay;
-	for (std::vector<BattleItem*>::const_iterator i = _recoverGuaranteed.begin(); i != _recoverGuaranteed.end(); ++i)
-	{
-		node["recoverGuaranteed"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
-	}
-	for (std::vector<BattleItem*>::const_iterator i = _recoverConditional.begin(); i != _recoverConditional.end(); ++i)
-	{
-		node["recoverConditional"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
-	}
-	node["music"] = _music;
-	node["baseItems"] = _baseItems->save();
-	node["turnLimit"] = _turnLimit;
-	node["chronoTrigger"] = int(_chronoTrigger);
-	node["cheatTurn"] = _cheatTurn;
-	_scriptValues.save(node, _rule->getScriptGlobal());
-
-	return node;
+		node.write("moduleMap", _baseModules);
+	}
+	node.writeList("units", _units, [&](const BattleUnit *i) { return i->save(this->getMod()->getScriptGlobal()); });
+	node.writeList("items", _items, [&](const BattleItem *i) { return i->save(this->getMod()->getScriptGlobal()); });
+	node.write("tuReserved", (int)_tuReserved);
+	node.write("kneelReserved", _kneelReserved);
+	node.write("depth", _depth);
+	node.write("ambience", _ambience);
+	node.write("ambientVolume", _ambientVolume);
+	node.write("ambienceRandom", _ambienceRandom);
+	node.write("minAmbienceRandomDelay", _minAmbienceRandomDelay);
+	node.write("maxAmbienceRandomDelay", _maxAmbienceRandomDelay);
+	node.write("currentAmbienceDelay", _currentAmbienceDelay);
+	node.writeList("recoverGuaranteed", _recoverGuaranteed, [&](const BattleItem *i) { return i->save(this->getMod()->getScriptGlobal()); });
+	node.writeList("recoverConditional", _recoverConditional, [&](const BattleItem *i) { return i->save(this->getMod()->getScriptGlobal()); });
+	node.write("music", _music);
+	node.write("baseItems", _baseItems->save());
+	node.write("turnLimit", _turnLimit);
+	node.write("chronoTrigger", int(_chronoTrigger));
+	node.write("cheatTurn", _cheatTurn);
+	YAML::Node scriptNode;
+	_scriptValues.save(scriptNode, _rule->getScriptGlobal());
+	node.writeAll(scriptNode);
+	node.end();
 }
 
 /**
@@ -965,6 +958,36 @@ std::vector<BattleUnit*> *SavedBattleGame::getUnits()
 	return &_units;
 }
 
+/**
+ * Gets units that can be within given 2d distance of position,
+ * using a grid of unit positions instead of checking every unit.
+ * Result can contain more distant units, callers still need to check the distance.
+ * @param pos Center of the search.
+ * @param range Distance in tiles.
+ * @param result Gets units in the same order as in getUnits(), callers keep it to reuse its memory.
+ * @param extra Optional units that need to be in result even when out of range.
+ */
+void SavedBattleGame::getUnitsInRange(Position pos, int range, std::vector<BattleUnit*> &result, const std::vector<BattleUnit*> *extra)
+{
+	if (!Options::oxceUnitIndex)
+	{
+		result = _units;
+		return;
+	}
+	_unitIndex->update(_units, _mapsize_x, _mapsize_y);
+	_unitIndex->getUnitsInRange(pos, range, extra, result);
+}
+
+/**
+ * Makes the unit index rebuild on its next use. Needs to be called
+ * whenever units are added to or removed from the list of units,
+ * as a freed unit can be replaced by a new one at the same address.
+ */
+void SavedBattleGame::invalidateUnitIndex()
+{
+	_unitIndex->invalidate();
+}
+
 /**
  * Gets the list of items.
  * @return Pointer to the list of items.
@@ -1219,6 +1242,14 @@ void SavedBattleGame::endTurn()
 			selectNextPlayerUnit();
 	}
 
+	// fire and smoke spread and units get new TUs
+	if (_reachabilityCache->getHits() + _reachabilityCache->getMisses() > 0)
+	{
+		Log(LOG_DEBUG) << "Reachability cache on turn " << _turn << ": " << _reachabilityCache->getHits() << " hits, " << _reachabilityCache->getMisses() << " misses";
+	}
+	_reachabilityCache->invalidate();
+	_reachabilityCache->resetCounters();
+
 	auto tally = _battleState->getBattleGame()->tallyUnits();
 
 	if ((_turn > _cheatTurn / 2 && tally.liveAliens <= 2) || _turn > _cheatTurn)
@@ -2905,6 +2936,15 @@ const HitLog *SavedBattleGame::getHitLog() const
 	return _hitLog;
 }
 
+/**
+ * Gets the cache of reachable tiles shared by all units.
+ * @return Reachability cache.
+ */
+ReachabilityCache *SavedBattleGame::getReachabilityCache()
+{
+	return _reachabilityCache;
+}
+
 /**
  * Resets all unit hit state flags.
  */
@@ -43,6 +43,8 @@ class State;
 class ItemContainer;
 class RuleItem;
 class HitLog;
+class ReachabilityCache;
+class BattleUnitIndex;
 enum HitLogEntryType : int;
 
 /**
@@ -110,6 +112,8 @@ private:
 	bool _beforeGame;
 	std::string _hiddenMovementBackground;
 	HitLog *_hitLog;
+	ReachabilityCache *_reachabilityCache;
+	BattleUnitIndex *_unitIndex;
 	ScriptValues<SavedBattleGame> _scriptValues;
 	/// Selects a soldier.
 	BattleUnit *selectPlayerUnit(int dir, bool checkReselect = false, bool setReselect = false, bool checkInventory = false);
@@ -123,7 +127,7 @@ public:
 	/// Loads a saved battle game from YAML.
 	void load(const YAML::Node& node, Mod *mod, SavedGame* savedGame);
 	/// Saves a saved battle game to YAML.
-	YAML::Node save() const;
+	void save(YAML::Emitter &out) const;
 	/// Sets the dimensions of the map and initializes it.
 	void initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool resetTerrain = true);
 	/// Initialises the pathfinding and tile engine.
@@ -191,6 +195,10 @@ public:
 	std::vector<BattleItem*> *getItems();
 	/// Gets a pointer to the list of units.
 	std::vector<BattleUnit*> *getUnits();
+	/// Gets units that can be within given distance of position.
+	void getUnitsInRange(Position pos, int range, std::vector<BattleUnit*> &result, const std::vector<BattleUnit*> *extra = nullptr);
+	/// Makes the unit index rebuild after units were added to or removed from the list.
+	void invalidateUnitIndex();
 	/// Gets terrain size x.
 	int getMapSizeX() const;
 	/// Gets terrain size y.
@@ -562,6 +570,8 @@ public:
 	void appendToHitLog(HitLogEntryType type, UnitFaction faction, const std::string &text);
 	/// Gets the hit log.
 	const HitLog *getHitLog() const;
+	/// Gets the reachability cache.
+	ReachabilityCache *getReachabilityCache();
 	/// Reset all the unit hit state flags.
 	void resetUnitHitStates();
 };
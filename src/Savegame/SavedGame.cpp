@@ -34,6 +34,8 @@
 #include "../Engine/ScriptBind.h"
 #include "SavedBattleGame.h"
 #include "SerializationHelper.h"
+#include "SaveIndex.h"
+#include "SaveWriter.h"
 #include "GameTime.h"
 #include "Country.h"
 #include "Base.h"
@@ -283,6 +285,8 @@ static bool _isCurrentGameType(const SaveInfo &saveInfo, const std::string &curM
  */
 std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 {
+	// saves still written in background would be listed half finished
+	SaveWriter::getShared().wait();
 	std::vector<SaveInfo> info;
 	std::string curMaster = Options::getActiveMaster();
 	auto saves = CrossPlatform::getFolderContents(Options::getMasterUserFolder(), "sav");
@@ -297,7 +301,7 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 		auto filename = std::get<0>(*i);
 		try
 		{
-			SaveInfo saveInfo = getSaveInfo(filename, lang);
+			SaveInfo saveInfo = getSaveInfo(filename, std::get<2>(*i), lang);
 			if (!_isCurrentGameType(saveInfo, curMaster))
 			{
 				continue;
@@ -315,19 +319,21 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 			continue;
 		}
 	}
+	SaveIndex::flush();
 
 	return info;
 }
 
 /**
  * Gets the info of a specific save file.
+ * Header of the save comes from the save index when the file did not change.
  * @param file Save filename.
+ * @param mtime Modification time of the file.
  * @param lang Loaded language.
  */
-SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
+SaveInfo SavedGame::getSaveInfo(const std::string &file, time_t mtime, Language *lang)
 {
-	std::string fullname = Options::getMasterUserFolder() + file;
-	YAML::Node doc = YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
+	YAML::Node doc = SaveIndex::getHeader(file, mtime);
 	SaveInfo save;
 
 	save.fileName = file;
@@ -360,7 +366,7 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 		save.reserved = false;
 	}
 
-	save.timestamp = CrossPlatform::getDateModified(fullname);
+	save.timestamp = mtime;
 	std::pair<std::string, std::string> str = CrossPlatform::timeToString(save.timestamp);
 	save.isoDate = str.first;
 	save.isoTime = str.second;
@@ -398,6 +404,7 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
  */
 void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 {
+	SaveWriter::getShared().wait();
 	std::string filepath = Options::getMasterUserFolder() + filename;
 	std::vector<YAML::Node> file = YAML::LoadAll(*CrossPlatform::readFile(filepath));
 	// Get brief save info
@@ -780,15 +787,18 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 }
 
 /**
- * Saves a saved game's contents to a YAML file.
- * @param filename YAML filename.
+ * Saves a saved game's contents to a YAML buffer,
+ * writing it to disk is left to SaveWriter.
+ * @param mod Mod used by the game.
+ * @param brief Returns brief game info used in the saves list.
+ * @return Serialized save.
  */
-void SavedGame::save(const std::string &filename, Mod *mod) const
+std::string SavedGame::save(Mod *mod, YAML::Node &brief) const
 {
 	YAML::Emitter out;
 
 	// Saves the brief game info used in the saves list
-	YAML::Node brief;
+	brief = YAML::Node();
 	brief["name"] = _name;
 	brief["version"] = OPENXCOM_VERSION_SHORT;
 	std::string git_sha = OPENXCOM_VERSION_GIT;
@@ -819,105 +829,66 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 	out << brief;
 	// Saves the full game data to the save
 	out << YAML::BeginDoc;
-	YAML::Node node;
-	node["difficulty"] = (int)_difficulty;
-	node["end"] = (int)_end;
-	node["monthsPassed"] = _monthsPassed;
-	node["graphRegionToggles"] = _graphRegionToggles;
-	node["graphCountryToggles"] = _graphCountryToggles;
-	node["graphFinanceToggles"] = _graphFinanceToggles;
-	node["rng"] = RNG::getSeed();
-	node["funds"] = _funds;
-	node["maintenance"] = _maintenance;
-	node["userNotes"] = _userNotes;
-	node["researchScores"] = _researchScores;
-	node["incomes"] = _incomes;
-	node["expenditures"] = _expenditures;
-	node["warned"] = _warned;
-	node["globeLon"] = serializeDouble(_globeLon);
-	node["globeLat"] = serializeDouble(_globeLat);
-	node["globeZoom"] = _globeZoom;
-	node["ids"] = _ids;
-	for (std::vector<Country*>::const_iterator i = _countries.begin(); i != _countries.end(); ++i)
-	{
-		node["countries"].push_back((*i)->save());
-	}
-	for (std::vector<Region*>::const_iterator i = _regions.begin(); i != _regions.end(); ++i)
-	{
-		node["regions"].push_back((*i)->save());
-	}
-	for (std::vector<Base*>::const_iterator i = _bases.begin(); i != _bases.end(); ++i)
-	{
-		node["bases"].push_back((*i)->save());
-	}
-	for (std::vector<Waypoint*>::const_iterator i = _waypoints.begin(); i != _waypoints.end(); ++i)
-	{
-		node["waypoints"].push_back((*i)->save());
-	}
-	for (std::vector<MissionSite*>::const_iterator i = _missionSites.begin(); i != _missionSites.end(); ++i)
-	{
-		node["missionSites"].push_back((*i)->save());
-	}
+	// the map is written key by key, big lists one element at a time
+	YamlMapWriter node(out);
+	node.write("difficulty", (int)_difficulty);
+	node.write("end", (int)_end);
+	node.write("monthsPassed", _monthsPassed);
+	node.write("graphRegionToggles", _graphRegionToggles);
+	node.write("graphCountryToggles", _graphCountryToggles);
+	node.write("graphFinanceToggles", _graphFinanceToggles);
+	node.write("rng", RNG::getSeed());
+	node.write("funds", _funds);
+	node.write("maintenance", _maintenance);
+	node.write("userNotes", _userNotes);
+	node.write("researchScores", _researchScores);
+	node.write("incomes", _incomes);
+	node.write("expenditures", _expenditures);
+	node.write("warned", _warned);
+	node.write("globeLon", serializeDouble(_globeLon));
+	node.write("globeLat", serializeDouble(_globeLat));
+	node.write("globeZoom", _globeZoom);
+	node.write("ids", _ids);
+	node.writeList("countries", _countries, [](const Country *i) { return i->save(); });
+	node.writeList("regions", _regions, [](const Region *i) { return i->save(); });
+	node.writeList("bases", _bases, [](const Base *i) { return i->save(); });
+	node.writeList("waypoints", _waypoints, [](const Waypoint *i) { return i->save(); });
+	node.writeList("missionSites", _missionSites, [](const MissionSite *i) { return i->save(); });
 	// Alien bases must be saved before alien missions.
-	for (std::vector<AlienBase*>::const_iterator i = _alienBases.begin(); i != _alienBases.end(); ++i)
-	{
-		node["alienBases"].push_back((*i)->save());
-	}
+	node.writeList("alienBases", _alienBases, [](const AlienBase *i) { return i->save(); });
 	// Missions must be saved before UFOs, but after alien bases.
-	for (std::vector<AlienMission *>::const_iterator i = _activeMissions.begin(); i != _activeMissions.end(); ++i)
-	{
-		node["alienMissions"].push_back((*i)->save());
-	}
+	node.writeList("alienMissions", _activeMissions, [](const AlienMission *i) { return i->save(); });
 	// UFOs must be after missions
-	for (std::vector<Ufo*>::const_iterator i = _ufos.begin(); i != _ufos.end(); ++i)
-	{
-		node["ufos"].push_back((*i)->save(getMonthsPassed() == -1));
-	}
-	for (std::vector<GeoscapeEvent *>::const_iterator i = _geoscapeEvents.begin(); i != _geoscapeEvents.end(); ++i)
-	{
-		node["geoscapeEvents"].push_back((*i)->save());
-	}
-	for (std::vector<const RuleResearch *>::const_iterator i = _discovered.begin(); i != _discovered.end(); ++i)
-	{
-		node["discovered"].push_back((*i)->getName());
-	}
-	for (std::vector<const RuleResearch *>::const_iterator i = _poppedResearch.begin(); i != _poppedResearch.end(); ++i)
-	{
-		node["poppedResearch"].push_back((*i)->getName());
-	}
-	node["generatedEvents"] = _generatedEvents;
-	node["ufopediaRuleStatus"] = _ufopediaRuleStatus;
-	node["manufactureRuleStatus"] = _manufactureRuleStatus;
-	node["researchRuleStatus"] = _researchRuleStatus;
-	node["hiddenPurchaseItems"] = _hiddenPurchaseItemsMap;
-	node["alienStrategy"] = _alienStrategy->save();
-	for (std::vector<Soldier*>::const_iterator i = _deadSoldiers.begin(); i != _deadSoldiers.end(); ++i)
-	{
-		node["deadSoldiers"].push_back((*i)->save(mod->getScriptGlobal()));
-	}
+	node.writeList("ufos", _ufos, [&](const Ufo *i) { return i->save(getMonthsPassed() == -1); });
+	node.writeList("geoscapeEvents", _geoscapeEvents, [](const GeoscapeEvent *i) { return i->save(); });
+	node.writeList("discovered", _discovered, [](const RuleResearch *i) { return i->getName(); });
+	node.writeList("poppedResearch", _poppedResearch, [](const RuleResearch *i) { return i->getName(); });
+	node.write("generatedEvents", _generatedEvents);
+	node.write("ufopediaRuleStatus", _ufopediaRuleStatus);
+	node.write("manufactureRuleStatus", _manufactureRuleStatus);
+	node.write("researchRuleStatus", _researchRuleStatus);
+	node.write("hiddenPurchaseItems", _hiddenPurchaseItemsMap);
+	node.write("alienStrategy", _alienStrategy->save());
+	node.writeList("deadSoldiers", _deadSoldiers, [&](const Soldier *i) { return i->save(mod->getScriptGlobal()); });
 	for (int j = 0; j < MAX_EQUIPMENT_LAYOUT_TEMPLATES; ++j)
 	{
 		std::ostringstream oss;
 		oss << "globalEquipmentLayout" << j;
 		std::string key = oss.str();
-		if (!_globalEquipmentLayout[j].empty())
-		{
-			for (std::vector<EquipmentLayoutItem*>::const_iterator i = _globalEquipmentLayout[j].begin(); i != _globalEquipmentLayout[j].end(); ++i)
-				node[key].push_back((*i)->save());
-		}
+		node.writeList(key, _globalEquipmentLayout[j], [](const EquipmentLayoutItem *i) { return i->save(); });
 		std::ostringstream oss2;
 		oss2 << "globalEquipmentLayoutName" << j;
 		std::string key2 = oss2.str();
 		if (!_globalEquipmentLayoutName[j].empty())
 		{
-			node[key2] = _globalEquipmentLayoutName[j];
+			node.write(key2, _globalEquipmentLayoutName[j]);
 		}
 		std::ostringstream oss3;
 		oss3 << "globalEquipmentLayoutArmor" << j;
 		std::string key3 = oss3.str();
 		if (!_globalEquipmentLayoutArmor[j].empty())
 		{
-			node[key3] = _globalEquipmentLayoutArmor[j];
+			node.write(key3, _globalEquipmentLayoutArmor[j]);
 		}
 	}
 	for (int j = 0; j < MAX_CRAFT_LOADOUT_TEMPLATES; ++j)
@@ -925,43 +896,33 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 		std::ostringstream oss;
 		oss << "globalCraftLoadout" << j;
 		std::string key = oss.str();
-		if (!_globalCraftLoadout[j]->getContents()->empty())
+		if (!_globalCraftLoadout[j]->empty())
 		{
-			node[key] = _globalCraftLoadout[j]->save();
+			node.write(key, _globalCraftLoadout[j]->save());
 		}
 		std::ostringstream oss2;
 		oss2 << "globalCraftLoadoutName" << j;
 		std::string key2 = oss2.str();
 		if (!_globalCraftLoadoutName[j].empty())
 		{
-			node[key2] = _globalCraftLoadoutName[j];
+			node.write(key2, _globalCraftLoadoutName[j]);
 		}
 	}
 	if (Options::soldierDiaries)
 	{
-		for (std::vector<MissionStatistics*>::const_iterator i = _missionStatistics.begin(); i != _missionStatistics.end(); ++i)
-		{
-			node["missionStatistics"].push_back((*i)->save());
-		}
-	}
-	for (std::set<const RuleItem*>::const_iterator i = _autosales.begin(); i != _autosales.end(); ++i)
-	{
-		node["autoSales"].push_back((*i)->getName());
+		node.writeList("missionStatistics", _missionStatistics, [](const MissionStatistics *i) { return i->save(); });
 	}
+	node.writeList("autoSales", _autosales, [](const RuleItem *i) { return i->getName(); });
 	if (_battleGame != 0)
 	{
-		node["battleGame"] = _battleGame->save();
+		_battleGame->save(node.key("battleGame"));
 	}
-	_scriptValues.save(node, mod->getScriptGlobal());
-
-	out << node;
+	YAML::Node scriptNode;
+	_scriptValues.save(scriptNode, mod->getScriptGlobal());
+	node.writeAll(scriptNode);
+	node.end();
 
-
-	std::string filepath = Options::getMasterUserFolder() + filename;
-	if (!CrossPlatform::writeFile(filepath, out.c_str()))
-	{
-		throw Exception("Failed to save " + filepath);
-	}
+	return std::string(out.c_str(), out.size());
 }
 
 /**
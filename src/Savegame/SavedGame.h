@@ -174,7 +174,7 @@ private:
 	bool _alienContainmentChecked;
 	ScriptValues<SavedGame> _scriptValues;
 
-	static SaveInfo getSaveInfo(const std::string &file, Language *lang);
+	static SaveInfo getSaveInfo(const std::string &file, time_t mtime, Language *lang);
 public:
 	static const std::string AUTOSAVE_GEOSCAPE, AUTOSAVE_BATTLESCAPE, QUICKSAVE;
 	/// Creates a new saved game.
@@ -187,8 +187,8 @@ public:
 	static std::vector<SaveInfo> getList(Language *lang, bool autoquick);
 	/// Loads a saved game from YAML.
 	void load(const std::string &filename, Mod *mod, Language *lang);
-	/// Saves a saved game to YAML.
-	void save(const std::string &filename, Mod *mod) const;
+	/// Saves a saved game to YAML buffer.
+	std::string save(Mod *mod, YAML::Node &brief) const;
 	/// Gets the game name.
 	std::string getName() const;
 	/// Sets the game name.
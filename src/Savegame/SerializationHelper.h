@@ -19,6 +19,7 @@
  */
 #include <SDL_types.h>
 #include <string>
+#include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
 {
@@ -27,4 +28,60 @@ int unserializeInt(Uint8 **buffer, Uint8 sizeKey);
 void serializeInt(Uint8 **buffer, Uint8 sizeKey, int value);
 std::string serializeDouble(double value);
 
+/**
+ * Writes YAML map straight to emitter, one key at a time.
+ * Output is the same as assigning values to YAML::Node and emitting it,
+ * but the whole map never exists in memory at once.
+ */
+class YamlMapWriter
+{
+	YAML::Emitter &_out;
+public:
+	/// Starts new map.
+	YamlMapWriter(YAML::Emitter &out) : _out(out)
+	{
+		_out << YAML::BeginMap;
+	}
+	/// Writes one value.
+	template<typename T>
+	void write(const std::string &key, const T &value)
+	{
+		_out << YAML::Key << key << YAML::Value << YAML::Node(value);
+	}
+	/// Writes sequence of values created from list elements, nothing is written for empty list.
+	template<typename C, typename F>
+	void writeList(const std::string &key, const C &list, F func)
+	{
+		if (list.empty())
+		{
+			return;
+		}
+		_out << YAML::Key << key << YAML::Value << YAML::BeginSeq;
+		for (const auto &i : list)
+		{
+			_out << YAML::Node(func(i));
+		}
+		_out << YAML::EndSeq;
+	}
+	/// Writes all keys of map node.
+	void writeAll(const YAML::Node &node)
+	{
+		for (const auto &i : node)
+		{
+			_out << YAML::Key << i.first << YAML::Value << i.second;
+		}
+	}
+	/// Starts key with value written directly to emitter.
+	YAML::Emitter &key(const std::string &key)
+	{
+		_out << YAML::Key << key << YAML::Value;
+		return _out;
+	}
+	/// Ends the map.
+	void end()
+	{
+		_out << YAML::EndMap;
+	}
+};
+
 }
@@ -70,6 +70,7 @@ Tile::Tile(Position pos): _pos(pos), _unit(0), _visible(false), _preview(-1), _T
 		_objectsCache[i].discovered = 0;
 	}
 	_cache.isNoFloor = 1;
+	_cache.voxelDirty = 1;
 }
 
 /**
@@ -110,6 +111,7 @@ void Tile::load(const YAML::Node &node)
 	{
 		_objectsCache[2].currentFrame = 7;
 	}
+	_cache.voxelDirty = 1;
 	if (_fire || _smoke)
 	{
 		_animationOffset = RNG::seedless(0, 3);
@@ -141,6 +143,7 @@ void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 	_objectsCache[O_FLOOR].discovered = (boolFields & 4) ? 1 : 0;
 	_objectsCache[O_WESTWALL].currentFrame = (boolFields & 8) ? 7 : 0;
 	_objectsCache[O_NORTHWALL].currentFrame = (boolFields & 0x10) ? 7 : 0;
+	_cache.voxelDirty = 1;
 	if (_fire || _smoke)
 	{
 		_animationOffset = RNG::seedless(0, 3);
@@ -224,6 +227,7 @@ void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, TilePart pa
 	_objectsCache[part].isUfoDoor = dat ? dat->isUFODoor() : 0;
 	_objectsCache[part].offsetY = dat ? dat->getYOffset() : 0;
 	_objectsCache[part].isBackTileObject = dat ? dat->isBackTileObject() : 0;
+	_cache.voxelDirty = 1;
 	if (part == O_FLOOR || part == O_OBJECT)
 	{
 		int level = 0;
@@ -377,6 +381,7 @@ int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve, bo
 		if (unit && cost.Time && !cost.haveTU())
 			return 4;
 		_objectsCache[part].currentFrame = 1; // start opening door
+		_cache.voxelDirty = 1;
 		updateSprite((TilePart)part);
 		return 1;
 	}
@@ -396,6 +401,7 @@ int Tile::closeUfoDoor()
 		if (isUfoDoorOpen((TilePart)part))
 		{
 			_objectsCache[part].currentFrame = 0;
+			_cache.voxelDirty = 1;
 			retval = 1;
 			updateSprite((TilePart)part);
 		}
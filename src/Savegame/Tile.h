@@ -104,6 +104,7 @@ public:
 		Uint8 isNoFloor:1;
 		Uint8 bigWall:1;
 		Uint8 danger:1;
+		Uint8 voxelDirty:1;
 	};
 
 protected:
@@ -227,6 +228,23 @@ public:
 		return (_objectsCache[tp].isUfoDoor && _objectsCache[tp].currentFrame);
 	}
 
+	/**
+	 * Check if the terrain shape of this tile changed since the voxel grid last saw it.
+	 * @return True if the voxel block of this tile need rebuilding.
+	 */
+	bool isVoxelDirty() const
+	{
+		return _cache.voxelDirty;
+	}
+
+	/**
+	 * Mark the terrain shape of this tile as up to date in the voxel grid.
+	 */
+	void clearVoxelDirty()
+	{
+		_cache.voxelDirty = 0;
+	}
+
 	/**
 	 * Check if part is ufo door.
 	 * @param tp Part to check
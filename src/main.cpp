@@ -116,6 +116,12 @@ int main(int argc, char *argv[])
 	title << "OpenXcom " << OPENXCOM_VERSION_SHORT << OPENXCOM_VERSION_GIT;
 	Options::baseXResolution = Options::displayWidth;
 	Options::baseYResolution = Options::displayHeight;
+	if (Options::getHeadless())
+	{
+		// headless simulation, no window or sound
+		SDL_putenv((char *)"SDL_VIDEODRIVER=dummy");
+		SDL_putenv((char *)"SDL_AUDIODRIVER=dummy");
+	}
 
 	game = new Game(title.str());
 	State::setGamePtr(game);
@@ -123,6 +129,7 @@ int main(int argc, char *argv[])
 	game->run();
 
 	bool startUpdate = game->getUpdateFlag();
+	int exitCode = game->getExitCode();
 
 	// Comment those two for faster exit.
 	delete game;
@@ -133,7 +140,7 @@ int main(int argc, char *argv[])
 		CrossPlatform::startUpdateProcess();
 	}
 
-	return EXIT_SUCCESS;
+	return exitCode;
 }
 
 namespace OpenXcom